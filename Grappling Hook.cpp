@@ -9,6 +9,21 @@
 #include "src/Camera.h"
 #include "src/Misc.h"
 #include "src/Classes.h"
+#include "src/World.h"
+#include "src/RenderQueue.h"
+#include "src/Pipeline.h"
+#include "src/RenderGraph.h"
+#include "src/Bloom.h"
+#include "src/Outline.h"
+#include "src/TerrainRenderer.h"
+#include "src/Streaming.h"
+#include "src/Profiler.h"
+#include "src/ProfilerUI.h"
+#include "src/Log.h"
+#include "src/Input.h"
+#include "src/Level.h"
+#include <memory>
+#include <cstring>
 
 
 using namespace std;
@@ -17,37 +32,41 @@ float camdistance = 5.0f;  // Distance between camera and target
 float yaw = 0.0f;  // Rotation around Y-axis (left/right)
 float pitch = 0.0f;  // Rotation around X-axis (up/down)
 float offsetY = 5.0f;
-float thickness = 10.0f;
-float glowIntensity = 0.5f;
-float quality = 0.1f;
+float thickness = 10.0f; // Outline width in pixels
 Vector4 neoncolor = { 0.0f, 1.0f, 0.0f, 1.0f }; // Neon color for the outline effect
-Vector3 normalizedColor = {
-      neoncolor.x / 255.0f,
-      neoncolor.y / 255.0f,
-      neoncolor.z / 255.0f
-};
-int main() {
+// --record <file> writes every frame's input to a log, --replay <file> plays one back
+int main(int argc, char** argv) {
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--record") == 0) recordPath = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0) replayPath = argv[++i];
+    }
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE);
     InitWindow(1920, 1080, "Grapple");
+    Profiler::Instance().SetThreadName("Main");
+
+    // Everything big loads in the background; placeholders are used until it arrives
+    AssetStreamer streamer;
 
     // Model stuff
-    Model arrow = LoadModel("resources/models/arrow/arrow.gltf"); // Load model
-    RenderTexture2D target = LoadRenderTexture(GetScreenWidth(),GetScreenHeight()); // Create render texture
+    ModelAsset* arrow = AssetCache::Instance().AcquireModelAsync("resources/models/arrow/arrow.gltf", streamer);
+    // Frame drawing: scene -> outline -> bloom -> composite -> UI, with targets from a pool
+    RenderGraph graph;
+    RenderTargetPool targetPool;
     //Shader stuff
-    Shader outline = LoadShader(0,"src/Neon.frag");
-	//Texture stuff
-    Image img = LoadImage("resources/textures/heightmap.png");
-    ImageResize(&img, 256, 256);
-    Texture2D texture = LoadTextureFromImage(img);
-    cout << Vector3ToString({(float) img.width,(float)img.height,0 });
-
+    Bloom bloom; // neon glow around everything bright
+    bloom.Load();
+    Outline outline; // around the player and the grappled block
+    outline.Load();
+    Material ropeMaterial = LoadMaterialDefault(); // bright enough to glow
+    ropeMaterial.maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
     //Player stuff
     vector<const char*>playerAnims;
     playerAnims.push_back("resources/models/player/Vampire/Idle.glb");
     playerAnims.push_back("resources/models/player/Vampire/Run.glb");
-    Player player1 = Player(playerAnims, { 0,105,0 }, {0.01f,0.01f,0.01f });
-    player1.rotation = { 0,0,0 };
-    player1.moveSpeed = 10.0f;
-    player1.animIndex = 0;
+    Player player1 = Player(playerAnims, levelSpawn, levelPlayerScale, &streamer);
+    PlaceLevelPlayer(player1);
 
 
     // Camera and ImGui setup
@@ -74,92 +93,195 @@ int main() {
 
 
     //blocks
-    Block ground ={{0,-0.9,0},{100,10,100}};
-	ground.layer = 0;
-	ground.color = DARKGRAY;
-	ground.name = "Ground";
-    ground.mesh = GenMeshHeightmap(img, ground.scale);
-    Block wall2 = { {0,0,-10},{1,2,1} };
-	Block wall3 = { {10,0,10},{1,2,1} };
-	vector<Block> blocks;
-	blocks.push_back(wall2);
-	blocks.push_back(wall3);
-	blocks.push_back(ground);
+    // Flat stand-in with the heightmap's layout until the real one streams in
+    Terrain terrain;
+    terrain.LoadHeights(vector<float>(4, 0.0f), 2, 2);
+    World world;
+	vector<Block>& blocks = world.blocks;
+    int groundIndex = BuildLevel(world, terrain);
+    TerrainRenderer terrainRenderer; // the ground, in chunks streamed in around the camera
+    terrainRenderer.Build(terrain);
+    world.player = &player1;
+
+    struct HeightmapLoad {
+        Terrain terrain;
+        TerrainBuild chunks;
+        bool loaded = false;
+    };
+    shared_ptr<HeightmapLoad> heightmap = make_shared<HeightmapLoad>();
+    heightmap->chunks = terrainRenderer.NewBuild();
+    // The chunk quadtree is built with the heights; the main thread only uploads its root
+    streamer.Load([heightmap, origin = terrain.origin, size = terrain.size] {
+        heightmap->loaded = LoadLevelHeights(heightmap->terrain);
+        if (!heightmap->loaded) return;
+        heightmap->terrain.Place(origin, size);
+        heightmap->chunks.Prepare(heightmap->terrain);
+    }, [heightmap, &world, &terrain, &terrainRenderer, groundIndex] {
+        if (!heightmap->loaded) return;
+        Block& groundBlock = world.blocks[groundIndex];
+        terrain = move(heightmap->terrain);
+        world.RefreshBlock(groundBlock);
+        terrainRenderer.Install(heightmap->chunks, terrain);
+        // Don't leave the player inside hills that just appeared
+        Player& player = *world.player;
+        float groundY = terrain.GetHeight(player.position.x, player.position.z);
+        if (terrain.Contains(player.position.x, player.position.z) && player.position.y < groundY) {
+            player.position.y = player.previousPosition.y = groundY;
+        }
+    });
     Block* selectedBlock=nullptr;
-    Rope rope;
-	bool ropeActive = false;
-    SetTargetFPS(120);
+    Visibility visibility; // frustum, size culling and LOD, once a frame
+    const BoundingBox gridBounds = { { -5.0f, 0.0f, -5.0f }, { 5.0f, 0.0f, 5.0f } }; // DrawGrid(10, 1)
+    RenderQueue renderQueue;
+    FramePipeline pipeline(world);
+    ProfilerView profilerView;
+
+    InputSource inputs;
+    if (recordPath) inputs.Record(recordPath, world.clock.stepRate);
+    if (replayPath && inputs.Replay(replayPath)) world.clock.stepRate = inputs.GetReplayStepRate();
+    // A replay has to start from the level it was recorded against
+    if (inputs.IsRecording() || inputs.IsReplaying()) streamer.Flush();
+    int pendingAttach = -1; // picked last frame, attached at the start of this one
+    pipeline.Refresh();
     while (!WindowShouldClose()) {
-       
-        player1.PlayerController(rope,camera);
-        player1.Update(blocks);
-        player1.shader = outline;
+        Profiler::Instance().BeginFrame();
+        PROFILE_ZONE("Frame");
+        streamer.Update();
+        InputFrame input = inputs.Poll(camera);
+        if (!inputs.IsReplaying()) input.attachBlock = pendingAttach;
+        pendingAttach = -1;
+        if (input.attachBlock >= 0 && input.attachBlock < (int)blocks.size()) selectedBlock = &blocks[input.attachBlock];
+        // This frame simulates on a worker while the last one is drawn from
+        // its snapshot; the world is read-only here until pipeline.Finish()
+        pipeline.Begin(input);
+        FrameSnapshot& view = pipeline.Front();
 
 
-        if (IsKeyPressed(KEY_KP_ADD)) {
+        if (input.IsPressed(INPUT_CAMERA_FOLLOW)) {
             cameraMode = 1;
         }
-        if (IsKeyPressed(KEY_KP_SUBTRACT)) {
+        if (input.IsPressed(INPUT_CAMERA_ORBIT)) {
             cameraMode = 0;
         }
 
-	   	MainCamControls(camera, GetFrameTime(),player1,cameraMode);
-        BeginTextureMode(target); // Activate render texture
-        BeginMode3D(camera);
-        ClearBackground(PURPLE);  // Clear texture background
-        Vector3 lastPos = { 0,0 };
-		DrawGrid(10, 1); // Draw a grid
-        for (int i = 0; i < blocks.size(); i++) {
-            blocks[i].Draw(); // Draw blocks
+	   	MainCamControls(camera, input,view.player,cameraMode);
+        int screenWidth = GetScreenWidth();
+        int screenHeight = GetScreenHeight();
+        TargetDesc sceneDesc = { screenWidth, screenHeight };
+        visibility.Begin(camera, sceneDesc.GetAspect()); // the scene target is what gets culled
+        CharacterLod playerLod = visibility.TestCharacter(player1.GetRenderBounds(view.player));
+        {
+            PROFILE_ZONE("Animation");
+            player1.Animate(input.frameTime, playerLod, view.player); // skins on worker threads while blocks are drawn
         }
-		player1.Draw(); // Draw player
-        if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
-            selectedBlock = onMouseCollision(blocks, GetScreenToWorldRay(GetMousePosition(), camera), camera);
+        terrainRenderer.Update(visibility, streamer);
+        graph.Reset();
+        int scene = graph.AddTarget("Scene", sceneDesc);
+        graph.AddPass("Scene", {}, scene, [&](RenderGraph&) {
+            BeginMode3D(camera);
+            ClearBackground(PURPLE);  // Clear texture background
+			if (visibility.frustum.IntersectsBox(gridBounds)) DrawGrid(10, 1); // Draw a grid
+            renderQueue.Build(blocks, world.broadphase, visibility);
+            renderQueue.Submit(GetSharedResources().instancedMaterial); // Draw blocks
+            Material& groundMaterial = GetSharedResources().defaultMaterial;
+            groundMaterial.maps[MATERIAL_MAP_DIFFUSE].color = blocks[groundIndex].color;
+            terrainRenderer.Draw(groundMaterial); // Draw ground
+            if (playerLod.visible) {
+                PROFILE_ZONE("Draw player");
+                player1.Draw(view.player); // Draw player
+            }
+            if (input.IsPressed(INPUT_POINTER) && !inputs.IsReplaying()) {
+                PROFILE_ZONE("Picking");
+                selectedBlock = onMouseCollision(blocks, world.broadphase, GetScreenToWorldRay(input.mousePosition, camera), camera);
+                if (selectedBlock != nullptr) {
+                    pendingAttach = (int)(selectedBlock - blocks.data());
+                }
+            }
+
+            if (view.ropeCount > 0) {
+                PROFILE_ZONE("Draw ropes");
+                view.ropes.Upload(); // tessellated by the simulation job
+                view.ropes.Draw(ropeMaterial);
+            }
+            EndMode3D();
+        });
+        outline.thickness = thickness;
+        outline.color = neoncolor;
+        outline.AddPasses(graph, scene, camera, [&] {
+            if (playerLod.visible) {
+                outline.SetId(1);
+                player1.DrawMask(view.player, outline.GetMaskShader());
+            }
             if (selectedBlock != nullptr) {
-                rope.Init(50, player1.position, selectedBlock->position);
-                ropeActive = true;
+                outline.SetId(2);
+                if (selectedBlock->terrain != nullptr) terrainRenderer.Draw(outline.GetMaskMaterial());
+                else selectedBlock->Draw(outline.GetMaskMaterial());
             }
-        }
+        });
+        int glow = bloom.AddPasses(graph, scene);
+        graph.AddPass("Composite", { scene, glow }, RenderGraph::screen, [&](RenderGraph& g) {
+            ClearBackground(BLACK);
+            bloom.Composite(g, scene, glow, screenWidth, screenHeight); // Draw the scene with the glow added
+        });
+        graph.AddPass("UI", {}, RenderGraph::screen, [&](RenderGraph&) {
+            // The world is ours again: the UI below may edit it
+            pipeline.Finish();
+            rlImGuiBegin();
+			ImGui::Begin("Blocks");
+            ImGui::SliderFloat("Camera FOV", &camera.fovy, 1.0f, 100.0f);
+			ImGui::DragFloat3("Player Position", (float*)&player1.position, 0.1f);
+            ImGui::InputInt("Player Animation Index", &player1.animIndex);
+            ImGui::Text("Blocks drawn: %d (culled %d, %d batches)", renderQueue.visibleCount, renderQueue.culledCount, (int)renderQueue.batches.size());
+            ImGui::Text("Ground chunks: %d drawn (%d triangles), %d of %d loaded", terrainRenderer.drawnCount,
+                terrainRenderer.drawnTriangles, terrainRenderer.GetResidentCount(), terrainRenderer.GetChunkCount());
+            if (!streamer.IsIdle()) ImGui::Text("Loading: %d assets", streamer.GetPendingCount());
+            if (inputs.IsRecording()) ImGui::Text("Recording input to %s", recordPath);
+            if (inputs.IsReplaying()) ImGui::Text("Replaying %s", replayPath);
+			ImGui::DragFloat3("Camera.position", (float*)&camera.position, 0.1f);
+            profilerView.Draw();
+			ImGui::End();
+            if (ShowBlocksUI(selectedBlock)) world.RefreshBlock(*selectedBlock); // Show blocks UI
+            ImGui::Begin("Camera");
+            ImGui::SliderFloat("Offset Y", &offsetY, -10.0, 10.0);
+			ImGui::ColorEdit4("Outline Color", (float*)&neoncolor);
+		ImGui::SliderFloat("Outline Thickness", &thickness, 1.0f, 20.0f);
+		ImGui::ColorEdit4("Glow Color", (float*)&bloom.color);
+			ImGui::SliderFloat("Glow Intensity", &bloom.intensity, 0.0f, 100.0f);
+			ImGui::SliderFloat("Glow Threshold", &bloom.threshold, 0.0f, 1.0f);
+            for (auto& toggle : graph.GetToggles()) ImGui::Checkbox(toggle.first, &toggle.second);
+            ImGui::Text("Render targets: %d (%.1f MB)", targetPool.GetCount(), targetPool.GetBytes() / (1024.0f * 1024.0f));
+            ImGui::End();
+            rlImGuiEnd();
+			DrawText(TextFormat("Camera Mode:%d", cameraMode), 10, 40, 20, WHITE); // Draw camera mode
+			DrawFPS(10, 10); // Draw FPS
+        });
+        graph.Compile();
 
-        if (ropeActive && selectedBlock != nullptr) {
-			BeginShaderMode(outline);
-            rope.Update(player1.position, selectedBlock->position);		
-            rope.OnRopeCollision(blocks);
-            rope.DrawRope();
-            EndShaderMode();
-        }
-        EndMode3D();
-        EndTextureMode(); // End render texture mode
-        // Begin Drawing (apply postprocessing)
         BeginDrawing();
-        ClearBackground(BLACK);
-        DrawTextureRec(target.texture, { 0, 0, (float)target.texture.width, (float)-target.texture.height },  { 0, 0 }, WHITE); // Draw the render texture with applied shade
+        graph.Execute(targetPool);
+        pipeline.Finish();
+        inputs.EndFrame(input, pipeline.Front().playerPosition);
 		if (selectedBlock != nullptr) { 
-			if (IsKeyPressed(KEY_E)) {
+			if (input.IsPressed(INPUT_FOCUS_SELECTED)) {
 				camera.target = { selectedBlock->position.x,selectedBlock->position.y,selectedBlock->position.z };
 			}
 		}
-        rlImGuiBegin();
-		ImGui::Begin("Blocks");
-        ImGui::SliderFloat("Camera FOV", &camera.fovy, 1.0f, 100.0f);
-		ImGui::DragFloat3("Player Position", (float*)&player1.position, 0.1f);
-        ImGui::InputInt("Player Animation Index", &player1.animIndex);
-		ImGui::DragFloat3("Camera.position", (float*)&camera.position, 0.1f);
-		ImGui::End();
-        ShowBlocksUI(selectedBlock); // Show blocks UI
-        ImGui::Begin("Camera");
-        ImGui::SliderFloat("Offset Y", &offsetY, -10.0, 10.0);
-		ImGui::ColorEdit4("Outline Color", (float*)&neoncolor);
-		ImGui::SliderFloat("Glow Intensity", &glowIntensity, 0.0f, 100.0f);
-		ImGui::SliderFloat("Quality", &quality, 0.0f, 0.1f);
-        ImGui::End();
-        rlImGuiEnd();
-		DrawText(TextFormat("Camera Mode:%d", cameraMode), 10, 40, 20, WHITE); // Draw camera mode
-		DrawFPS(10, 10); // Draw FPS
-        EndDrawing();
+        {
+            PROFILE_ZONE("Present");
+            EndDrawing();
+        }
+        Logger::Instance().Flush();
     }
-	UnloadRenderTexture(target); 
-	UnloadModel(arrow);
+    inputs.Finish();
+    streamer.Flush(); // nothing may still be loading into what we unload below
+    targetPool.Unload();
+    bloom.Unload();
+    outline.Unload();
+    pipeline.Unload();
+    UnloadMaterial(ropeMaterial);
+	AssetCache::Instance().Release(arrow);
+    terrainRenderer.Unload();
+    UnloadSharedResources();
     // Cleanup
     CloseWindow(); // Close window and OpenGL context
     return 0;
@@ -0,0 +1,1084 @@
+// Headless benchmarks. Nothing here opens a window or touches the GPU, so they
+// run on a build box without one. Build from the repo root and link raylib as usual:
+//   g++ -O2 -std=c++20 -I. -I<raylib>/src -I<imgui> bench/Benchmarks.cpp <imgui sources> -lraylib -pthread -o grapple_bench
+// Tables grow the problem size; "growth" is the cost ratio to the row above.
+// "grapple_bench --replay <log>" steps a session recorded by the game instead.
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "src/RopeSolver.h"
+#include "src/Broadphase.h"
+#include "src/Terrain.h"
+#include "src/RenderQueue.h"
+#include "src/RopeMesh.h"
+#include "src/World.h"
+#include "src/Replay.h"
+#include "src/Pipeline.h"
+#include "src/Bloom.h"
+#include "src/Outline.h"
+#include "src/TerrainRenderer.h"
+
+// Results are written here so the optimizer can't drop the benchmarked work
+volatile int benchSink = 0;
+
+// Runs fn reps times and returns the average cost in nanoseconds
+template <typename F>
+double TimeNs(int reps, F&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; i++) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / reps;
+}
+
+// A sagging rope pinned at both ends, like Rope::Init produces
+void MakeRope(RopePoints& p, int count) {
+    p.Resize(count);
+    for (int i = 0; i < count; i++) {
+        p.x[i] = p.oldX[i] = (float)i * 0.25f;
+        p.y[i] = p.oldY[i] = sinf((float)i) * 0.1f;
+        p.z[i] = p.oldZ[i] = 0.0f;
+    }
+    p.invMass[0] = 0.0f;
+    p.invMass[count - 1] = 0.0f;
+    p.rest.assign(count, 0.25f);
+    p.UpdateWeights();
+}
+
+void BenchRopeSolver() {
+    printf("Rope step (integrate + 20 iterations)\n");
+    printf("%8s %14s %14s %8s\n", "points", "scalar ns", "simd ns", "speedup");
+    for (int count : { 16, 64, 256, 1024 }) {
+        RopePoints scalar, simd;
+        MakeRope(scalar, count);
+        MakeRope(simd, count);
+        int reps = 2000000 / count;
+
+        double scalarNs = TimeNs(reps, [&] {
+            RopeIntegrate(scalar, 0.05f, false);
+            RopeSolve(scalar, 20, 0.0f, false);
+        });
+        double simdNs = TimeNs(reps, [&] {
+            RopeIntegrate(simd, 0.05f, true);
+            RopeSolve(simd, 20, 0.0f, true);
+        });
+        printf("%8d %14.0f %14.0f %7.2fx\n", count, scalarNs, simdNs, scalarNs / simdNs);
+    }
+}
+
+float RandomRange(float lo, float hi) {
+    return lo + (hi - lo) * ((float)rand() / (float)RAND_MAX);
+}
+
+// Blocks scattered at constant density, so the level grows with the block count
+void MakeLevel(std::vector<BoundingBox>& boxes, int count) {
+    float extent = sqrtf((float)count) * 4.0f;
+    boxes.clear();
+    for (int i = 0; i < count; i++) {
+        Vector3 center = { RandomRange(-extent, extent), RandomRange(0.0f, 10.0f), RandomRange(-extent, extent) };
+        Vector3 half = { RandomRange(0.5f, 2.0f), RandomRange(0.5f, 2.0f), RandomRange(0.5f, 2.0f) };
+        boxes.push_back({ Vector3Subtract(center, half), Vector3Add(center, half) });
+    }
+}
+
+void BenchBroadphase() {
+    printf("\nBlock query (rope point sized box)\n");
+    printf("%8s %14s %14s\n", "blocks", "brute ns", "tree ns");
+    srand(1);
+    for (int count : { 256, 1024, 4096, 16384, 65536 }) {
+        std::vector<BoundingBox> boxes;
+        MakeLevel(boxes, count);
+        AABBTree tree;
+        for (int i = 0; i < count; i++) tree.CreateProxy(boxes[i], i);
+
+        float extent = sqrtf((float)count) * 4.0f;
+        std::vector<BoundingBox> queries;
+        for (int i = 0; i < 1024; i++) {
+            Vector3 p = { RandomRange(-extent, extent), RandomRange(0.0f, 10.0f), RandomRange(-extent, extent) };
+            queries.push_back({ Vector3SubtractValue(p, 0.05f), Vector3AddValue(p, 0.05f) });
+        }
+
+        int hits = 0, q = 0;
+        double bruteNs = TimeNs(20000000 / count, [&] {
+            const BoundingBox& query = queries[q++ & 1023];
+            for (const BoundingBox& box : boxes) hits += AABBTree::Overlaps(box, query);
+        });
+        double treeNs = TimeNs(200000, [&] {
+            tree.Query(queries[q++ & 1023], [&](int) { hits++; return true; });
+        });
+        printf("%8d %14.0f %14.0f\n", count, bruteNs, treeNs);
+        benchSink = hits;
+    }
+
+    // Axis-aligned rays along a face of a unit box touch it; just outside they don't
+    AABBTree tree;
+    tree.margin = 0.0f;
+    tree.CreateProxy({ { 0, 0, 0 }, { 1, 1, 1 } }, 0);
+    int grazing = 0, outside = 0;
+    for (float offset : { 0.0f, 1.0f }) {
+        auto hits = [&](Ray ray) {
+            bool hit = false;
+            tree.RayQuery(ray, 100.0f, [&](int) { hit = true; return 100.0f; });
+            return hit;
+        };
+        grazing += hits({ { -5, offset, 0.5f }, { 1, 0, 0 } }) + hits({ { offset, 0.5f, -5 }, { 0, 0, 1 } });
+        float away = offset == 0.0f ? -0.001f : 1.001f;
+        outside += hits({ { -5, away, 0.5f }, { 1, 0, 0 } }) + hits({ { away, 0.5f, -5 }, { 0, 0, 1 } });
+    }
+    printf("Ray query, axis-aligned rays on a face: %d/4 hit, just outside: %d/4 hit\n", grazing, outside);
+}
+
+// What GetRayCollisionMesh does with the heightmap mesh: test every triangle
+RayCollision RaycastAllTriangles(const Terrain& terrain, Ray ray) {
+    RayCollision result = { 0 };
+    result.distance = FLT_MAX;
+    float cx = terrain.CellX(), cz = terrain.CellZ();
+    auto vertex = [&](int x, int z) {
+        return Vector3{ terrain.origin.x + x * cx, terrain.origin.y + terrain.heights[x + z * terrain.width] * terrain.size.y, terrain.origin.z + z * cz };
+    };
+    for (int z = 0; z < terrain.depth - 1; z++) {
+        for (int x = 0; x < terrain.width - 1; x++) {
+            Terrain::RayTriangle(ray, vertex(x, z), vertex(x, z + 1), vertex(x + 1, z), result);
+            Terrain::RayTriangle(ray, vertex(x + 1, z), vertex(x, z + 1), vertex(x + 1, z + 1), result);
+        }
+    }
+    return result;
+}
+
+void MakeTerrain(Terrain& terrain, int samples) {
+    std::vector<float> heights(samples * samples);
+    for (int z = 0; z < samples; z++) {
+        for (int x = 0; x < samples; x++) {
+            heights[x + z * samples] = 0.5f + 0.25f * sinf(x * 0.05f) * cosf(z * 0.07f);
+        }
+    }
+    terrain.LoadHeights(heights, samples, samples);
+    terrain.Place({ -50.0f, -0.9f, -50.0f }, { 100.0f, 10.0f, 100.0f });
+}
+
+void BenchTerrain() {
+    printf("\nGround query on a 256x256 heightmap\n");
+    Terrain terrain;
+    MakeTerrain(terrain, 256);
+    srand(2);
+
+    std::vector<Ray> downRays, pickRays;
+    for (int i = 0; i < 1024; i++) {
+        Vector3 p = { RandomRange(-50.0f, 50.0f), 12.0f, RandomRange(-50.0f, 50.0f) };
+        downRays.push_back({ p, { 0.0f, -1.0f, 0.0f } });
+        Vector3 eye = { RandomRange(-60.0f, 60.0f), 20.0f, RandomRange(-60.0f, 60.0f) };
+        pickRays.push_back({ eye, Vector3Normalize({ RandomRange(-1.0f, 1.0f), -0.4f, RandomRange(-1.0f, 1.0f) }) });
+    }
+
+    int q = 0;
+    float sum = 0.0f;
+    double meshDownNs = TimeNs(200, [&] { sum += RaycastAllTriangles(terrain, downRays[q++ & 1023]).distance; });
+    double heightNs = TimeNs(1000000, [&] { Ray& r = downRays[q++ & 1023]; sum += terrain.GetHeight(r.position.x, r.position.z); });
+    double meshPickNs = TimeNs(200, [&] { sum += RaycastAllTriangles(terrain, pickRays[q++ & 1023]).distance; });
+    double ddaPickNs = TimeNs(100000, [&] { sum += terrain.Raycast(pickRays[q++ & 1023]).distance; });
+    benchSink = (int)sum;
+
+    printf("%-28s %12.0f ns\n", "player: mesh raycast", meshDownNs);
+    printf("%-28s %12.0f ns\n", "player: height sample", heightNs);
+    printf("%-28s %12.0f ns\n", "picking: mesh raycast", meshPickNs);
+    printf("%-28s %12.0f ns\n", "picking: grid DDA", ddaPickNs);
+}
+
+// Linear is the frustum test over every block; tree walks the broadphase with
+// the size cull on top. "same" checks the tree path keeps exactly the blocks
+// a brute-force Visibility::IsVisible pass keeps.
+void BenchRenderQueue() {
+    printf("\nRender queue build (cull + instance buffers), camera inside the level\n");
+    printf("%8s %10s %12s %10s %12s %12s %6s\n", "blocks", "in frustum", "linear ns", "visible", "tree ns", "ns/visible", "same");
+    Color palette[4] = { WHITE, RED, DARKGRAY, PURPLE };
+    srand(3);
+    for (int count : { 1024, 4096, 16384, 65536, 262144 }) {
+        std::vector<Block> blocks;
+        AABBTree tree;
+        float extent = sqrtf((float)count) * 4.0f;
+        for (int i = 0; i < count; i++) {
+            Block block({ RandomRange(-extent, extent), RandomRange(0.0f, 10.0f), RandomRange(-extent, extent) },
+                { RandomRange(0.5f, 3.0f), RandomRange(0.5f, 3.0f), RandomRange(0.5f, 3.0f) },
+                { 0.0f, RandomRange(0.0f, 90.0f), 0.0f }, palette[i & 3]);
+            blocks.push_back(block);
+        }
+        for (int i = 0; i < count; i++) blocks[i].proxyId = tree.CreateProxy(blocks[i].GetBounds(), i);
+
+        Camera3D camera = { { 0.0f, 10.0f, -10.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, 90.0f, CAMERA_PERSPECTIVE };
+        Frustum frustum = ExtractFrustum(camera, 16.0f / 9.0f);
+        Visibility visibility;
+        visibility.Begin(camera, 16.0f / 9.0f);
+        RenderQueue queue;
+        int reps = count > 65536 ? 10 : 50;
+        double linearNs = TimeNs(reps, [&] { queue.Build(blocks, frustum); });
+        int inFrustum = queue.visibleCount;
+        double treeNs = TimeNs(reps, [&] { queue.Build(blocks, tree, visibility); });
+
+        int expected = 0;
+        for (Block& block : blocks) expected += visibility.IsVisible(block.GetRenderBounds()) ? 1 : 0;
+        printf("%8d %10d %12.0f %10d %12.0f %12.1f %6s\n", count, inFrustum, linearNs, queue.visibleCount, treeNs,
+            treeNs / (queue.visibleCount > 0 ? queue.visibleCount : 1), expected == queue.visibleCount ? "yes" : "NO");
+    }
+
+    // Animation rate picked for a 1.8 m character at a distance
+    Visibility visibility;
+    Camera3D camera = { { 0.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 1.0f }, { 0.0f, 1.0f, 0.0f }, 90.0f, CAMERA_PERSPECTIVE };
+    visibility.Begin(camera, 16.0f / 9.0f);
+    printf("  character LOD:");
+    for (float distance : { 3.0f, 10.0f, 30.0f, 100.0f, 1000.0f }) {
+        CharacterLod lod = visibility.TestCharacter({ { -0.4f, 0.0f, distance - 0.4f }, { 0.4f, 1.8f, distance + 0.4f } });
+        if (lod.visible) printf("  %.0f m: every %d", distance, lod.animationInterval);
+        else printf("  %.0f m: culled", distance);
+    }
+    printf("\n");
+}
+
+// CreateTransformMatrix as it was before the closed-form version, minus the
+// rlPushMatrix/rlPopMatrix pair, which needs an rlgl context
+Matrix LegacyTransformMatrix(Vector3 position, Vector3 rotation) {
+    Matrix translation = MatrixTranslate(position.x, position.y, position.z);
+    Matrix rotX = MatrixRotateX(DEG2RAD * rotation.x);
+    Matrix rotY = MatrixRotateY(DEG2RAD * rotation.y);
+    Matrix rotZ = MatrixRotateZ(DEG2RAD * rotation.z);
+    return MatrixMultiply(MatrixMultiply(rotZ, MatrixMultiply(rotY, rotX)), translation);
+}
+
+void BenchTransforms() {
+    printf("\nBlock transform, 4096 blocks\n");
+    const int count = 4096;
+    srand(4);
+    std::vector<Block> blocks;
+    TransformArrays arrays;
+    arrays.Resize(count);
+    for (int i = 0; i < count; i++) {
+        Block block({ RandomRange(-50.0f, 50.0f), RandomRange(0.0f, 10.0f), RandomRange(-50.0f, 50.0f) },
+            { RandomRange(0.5f, 3.0f), RandomRange(0.5f, 3.0f), RandomRange(0.5f, 3.0f) },
+            { RandomRange(0.0f, 360.0f), RandomRange(0.0f, 360.0f), RandomRange(0.0f, 360.0f) });
+        blocks.push_back(block);
+        arrays.Set(i, block.position, block.rotation, block.scale);
+    }
+    std::vector<Matrix> out(count);
+
+    double legacyNs = TimeNs(200, [&] {
+        for (int i = 0; i < count; i++) {
+            out[i] = MatrixMultiply(MatrixScale(blocks[i].scale.x, blocks[i].scale.y, blocks[i].scale.z),
+                LegacyTransformMatrix(blocks[i].position, blocks[i].rotation));
+        }
+    });
+    float maxError = 0.0f;
+    for (int i = 0; i < count; i++) {
+        Matrix m = ComposeTransform(blocks[i].position, blocks[i].rotation, blocks[i].scale);
+        const float* a = &m.m0;
+        const float* b = &out[i].m0;
+        for (int j = 0; j < 16; j++) maxError = fmaxf(maxError, fabsf(a[j] - b[j]));
+    }
+    double composeNs = TimeNs(200, [&] {
+        for (int i = 0; i < count; i++) out[i] = ComposeTransform(blocks[i].position, blocks[i].rotation, blocks[i].scale);
+    });
+    double batchNs = TimeNs(200, [&] { ComposeTransforms(arrays, out.data()); });
+    for (Block& block : blocks) block.UpdateTransform();
+    double cachedNs = TimeNs(200, [&] {
+        for (Block& block : blocks) block.UpdateTransform();
+    });
+    benchSink = (int)out[count - 1].m0;
+
+    printf("%-34s %10.1f ns/block\n", "legacy CreateTransformMatrix", legacyNs / count);
+    printf("%-34s %10.1f ns/block\n", "ComposeTransform", composeNs / count);
+    printf("%-34s %10.1f ns/block\n", "ComposeTransforms (SoA batch)", batchNs / count);
+    printf("%-34s %10.1f ns/block\n", "UpdateTransform, nothing moved", cachedNs / count);
+    printf("%-34s %10.2g\n", "max difference from legacy", maxError);
+}
+
+// Synthetic skeleton: every bone turns a little each frame, every vertex uses 4 bones
+void MakeClip(ModelAnimation& clip, std::vector<std::vector<Transform>>& frames, int bones, int frameCount) {
+    frames.assign(frameCount, std::vector<Transform>(bones));
+    static std::vector<Transform*> framePointers;
+    framePointers.resize(frameCount);
+    for (int f = 0; f < frameCount; f++) {
+        for (int b = 0; b < bones; b++) {
+            float angle = 0.05f * f + 0.1f * b;
+            frames[f][b] = { { (float)b * 0.1f, sinf(angle), 0.0f }, QuaternionFromAxisAngle({ 0, 1, 0 }, angle), { 1, 1, 1 } };
+        }
+        framePointers[f] = frames[f].data();
+    }
+    clip = {};
+    clip.boneCount = bones;
+    clip.frameCount = frameCount;
+    clip.framePoses = framePointers.data();
+}
+
+void BenchAnimation() {
+    const int bones = 64, frameCount = 120, characters = 32;
+    ModelAnimation clip;
+    std::vector<std::vector<Transform>> frames;
+    MakeClip(clip, frames, bones, frameCount);
+    printf("\nAnimation, %d bones, %d characters on one clip\n", bones, characters);
+
+    // Interpolating every character every frame, as without the cache
+    std::vector<Transform> pose(bones);
+    float frame = 0.0f;
+    double sampleNs = TimeNs(2000, [&] {
+        frame = fmodf(frame + 0.37f, (float)frameCount);
+        int f0 = (int)frame, f1 = (f0 + 1) % frameCount;
+        for (int c = 0; c < characters; c++) {
+            for (int b = 0; b < bones; b++) pose[b] = BlendTransform(frames[f0][b], frames[f1][b], frame - f0);
+        }
+        benchSink = (int)pose[bones - 1].translation.y;
+    });
+    PoseCache cache;
+    cache.Init(&clip);
+    frame = 0.0f;
+    double cachedNs = TimeNs(2000, [&] {
+        frame = fmodf(frame + 0.37f, (float)frameCount);
+        for (int c = 0; c < characters; c++) benchSink = (int)cache.Sample(cache.SampleIndex(frame))[bones - 1].translation.y;
+    });
+    printf("%-34s %10.0f ns/frame\n", "interpolate per character", sampleNs);
+    printf("%-34s %10.0f ns/frame\n", "PoseCache", cachedNs);
+
+    printf("%8s %14s %14s %8s\n", "vertices", "serial ns", "jobs ns", "speedup");
+    std::vector<Matrix> inverseBind(bones, MatrixIdentity()), skin;
+    ComputeSkinMatrices(frames[10].data(), inverseBind, skin);
+    for (int count : { 4096, 16384, 65536 }) {
+        std::vector<float> vertices(count * 3), normals(count * 3), animVertices(count * 3), animNormals(count * 3), weights(count * 4);
+        std::vector<unsigned char> ids(count * 4);
+        for (int v = 0; v < count; v++) {
+            for (int j = 0; j < 3; j++) { vertices[v * 3 + j] = RandomRange(-1.0f, 1.0f); normals[v * 3 + j] = j == 1 ? 1.0f : 0.0f; }
+            for (int j = 0; j < 4; j++) { ids[v * 4 + j] = (unsigned char)(rand() % bones); weights[v * 4 + j] = 0.25f; }
+        }
+        Mesh mesh = { 0 };
+        mesh.vertexCount = count;
+        mesh.vertices = vertices.data();
+        mesh.normals = normals.data();
+        mesh.boneIds = ids.data();
+        mesh.boneWeights = weights.data();
+
+        int reps = 20000000 / count;
+        double serialNs = TimeNs(reps, [&] { SkinVertices(mesh, skin.data(), animVertices.data(), animNormals.data(), 0, count); });
+        double jobsNs = TimeNs(reps, [&] {
+            JobCounter counter;
+            for (int first = 0; first < count; first += 4096) {
+                int last = std::min(first + 4096, count);
+                JobSystem::Get().Run(counter, [&, first, last] { SkinVertices(mesh, skin.data(), animVertices.data(), animNormals.data(), first, last); });
+            }
+            JobSystem::Get().Wait(counter);
+        });
+        benchSink = (int)animVertices[0];
+        printf("%8d %14.0f %14.0f %7.2fx\n", count, serialNs, jobsNs, serialNs / jobsNs);
+    }
+}
+
+// Level in a World: a heightmap ground plus blockCount boxes at constant density
+float MakeScene(World& world, Terrain& terrain, int blockCount) {
+    float extent = sqrtf((float)blockCount) * 4.0f + 8.0f;
+    MakeTerrain(terrain, 256);
+    Block ground({ 0.0f, -0.9f, 0.0f }, { extent * 2.0f, 10.0f, extent * 2.0f });
+    ground.layer = 0;
+    ground.terrain = &terrain;
+    world.AddBlock(ground);
+    for (int i = 0; i < blockCount; i++) {
+        Block block({ RandomRange(-extent, extent), RandomRange(0.0f, 10.0f), RandomRange(-extent, extent) },
+            { RandomRange(0.5f, 3.0f), RandomRange(0.5f, 3.0f), RandomRange(0.5f, 3.0f) },
+            { 0.0f, RandomRange(0.0f, 90.0f), 0.0f });
+        world.AddBlock(block);
+    }
+    return extent;
+}
+
+// Cost growth against the previous, smaller size ("-" for the first row)
+void PrintGrowth(double ns, double previousNs) {
+    if (previousNs > 0.0) printf(" %8.2fx\n", ns / previousNs);
+    else printf(" %9s\n", "-");
+}
+
+void BenchRopeUpdate() {
+    printf("\nRope::Update (anchors + integrate + solve), ns per step\n");
+    printf("%8s %12s %12s %12s %9s\n", "points", "5 it", "20 it", "80 it", "growth");
+    double previous = 0.0;
+    for (int count : { 16, 64, 256, 1024 }) {
+        double ns[3];
+        int column = 0;
+        for (int iterations : { 5, 20, 80 }) {
+            Rope rope;
+            rope.Init(count, { 0.0f, 5.0f, 0.0f }, { count * 0.25f, 5.0f, 0.0f });
+            rope.iterations = iterations;
+            rope.tolerance = 0.0f;
+            rope.adaptive = false;
+            int reps = 4000000 / (count * iterations);
+            ns[column++] = TimeNs(reps, [&] { rope.Update({ 0.0f, 5.0f, 0.0f }, { count * 0.25f, 5.0f, 0.0f }, 1.0f / 120.0f); });
+            benchSink = (int)rope.points.y[count / 2];
+        }
+        printf("%8d %12.0f %12.0f %12.0f", count, ns[0], ns[1], ns[2]);
+        PrintGrowth(ns[1], previous);
+        previous = ns[1];
+    }
+}
+
+// 600 steps of four situations, with every step at full resolution and
+// iteration count (fixed) and with merging and early-out on (adaptive)
+void BenchRopeAdaptive() {
+    printf("\nRope adaptive resolution and early-out, 50-point rope, 600 steps\n");
+    printf("%10s %9s %12s %8s %8s %10s\n", "case", "mode", "ns/step", "points", "sweeps", "lowest y");
+    World world;
+    Terrain flat;
+    flat.LoadHeights(std::vector<float>(16 * 16, 0.0f), 16, 16);
+    Block ground({ 0.0f, 0.0f, 0.0f }, { 100.0f, 1.0f, 100.0f });
+    ground.layer = 0;
+    ground.terrain = &flat;
+    world.AddBlock(ground);
+    world.AddBlock(Block({ 0.0f, 2.0f, 0.0f }, { 2.0f, 4.0f, 2.0f }));
+
+    // Ropes are made straight between the first pair of points, then held at the second
+    struct Case { const char* name; Vector3 start, end, heldStart, heldEnd; bool swing; };
+    Case cases[] = {
+        { "taut", { -10.0f, 20.0f, 10.0f }, { 10.0f, 20.0f, 10.0f }, { -11.0f, 20.0f, 10.0f }, { 11.0f, 20.0f, 10.0f }, false },
+        { "slack", { -10.0f, 20.0f, 30.0f }, { 10.0f, 20.0f, 30.0f }, { -7.0f, 20.0f, 30.0f }, { 7.0f, 20.0f, 30.0f }, false },
+        { "draped", { -8.0f, 6.0f, 0.0f }, { 8.0f, 6.0f, 0.0f }, { -6.0f, 6.0f, 0.0f }, { 6.0f, 6.0f, 0.0f }, false },
+        { "resting", { -8.0f, 0.05f, 20.0f }, { 8.0f, 0.05f, 20.0f }, { -8.0f, 0.05f, 20.0f }, { 8.0f, 0.05f, 20.0f }, false },
+        { "swinging", { 0.0f, 30.0f, -20.0f }, { 0.0f, 15.0f, -20.0f }, { 0.0f, 30.0f, -20.0f }, { 0.0f, 15.0f, -20.0f }, true },
+    };
+    for (const Case& c : cases) {
+        for (bool adaptive : { false, true }) {
+            Rope rope;
+            rope.Init(50, c.start, c.end);
+            rope.adaptive = adaptive;
+            if (!adaptive) rope.tolerance = 0.0f;
+            long long points = 0, sweeps = 0;
+            double ns = TimeNs(600, [&, step = 0]() mutable {
+                float t = step++ / 120.0f;
+                Vector3 end = c.swing ? Vector3{ 12.0f * sinf(t * 2.0f), 15.0f, -20.0f + 12.0f * cosf(t * 2.0f) } : c.heldEnd;
+                rope.Update(c.heldStart, end, 1.0f / 120.0f);
+                rope.OnRopeCollision(world.blocks, world.broadphase);
+                points += rope.numPoints;
+                sweeps += rope.lastIterations;
+            });
+            float lowest = FLT_MAX;
+            for (int i = 0; i < rope.numPoints; i++) lowest = fminf(lowest, rope.points.y[i]);
+            printf("%10s %9s %12.0f %8.1f %8.1f %10.3f\n", c.name, adaptive ? "adaptive" : "fixed", ns, points / 600.0, sweeps / 600.0, lowest);
+        }
+    }
+}
+
+// A slack rope dropped onto a thin tilted plank. It reaches ~0.8 units per
+// step, eight times the plank's thickness, so any point that isn't swept ends
+// up underneath.
+void BenchRopeContact() {
+    printf("\nRope falling onto a 0.1-thick plank tilted 15 degrees, 240 steps\n");
+    printf("%8s %12s %12s %12s\n", "points", "ns/step", "underneath", "contacts");
+    World world;
+    Block plank({ 0.0f, 5.0f, 0.0f }, { 20.0f, 0.1f, 4.0f }, { 0.0f, 0.0f, 15.0f });
+    world.AddBlock(plank);
+    const OrientedBox& box = world.blocks[0].GetOrientedBox();
+    for (int count : { 8, 16, 50 }) {
+        Rope rope;
+        rope.Init(count, { -16.0f, 12.0f, 0.0f }, { 16.0f, 12.0f, 0.0f });
+        rope.adaptive = false;
+        double ns = TimeNs(240, [&] {
+            rope.Update({ -8.0f, 12.0f, 0.0f }, { 8.0f, 12.0f, 0.0f }, 1.0f / 120.0f);
+            rope.OnRopeCollision(world.blocks, world.broadphase);
+        });
+        int underneath = 0, contacts = 0;
+        for (int i = 0; i < rope.numPoints; i++) {
+            Vector3 local = box.ToLocal(rope.GetPoint(i));
+            underneath += local.y < 0.0f && fabsf(local.x) < box.half.x && fabsf(local.z) < box.half.z;
+            contacts += rope.contact[i];
+        }
+        printf("%8d %12.0f %12d %12d\n", count, ns, underneath, contacts);
+    }
+}
+
+void BenchRopeCollision() {
+    printf("\nRope::OnRopeCollision, 256-point rope lying across the level\n");
+    printf("%8s %12s %12s %9s\n", "blocks", "ns/call", "ns/point", "growth");
+    srand(5);
+    double previous = 0.0;
+    for (int count : { 256, 4096, 65536 }) {
+        World world;
+        Terrain terrain;
+        float extent = MakeScene(world, terrain, count);
+        Rope rope;
+        rope.Init(256, { -extent, 4.0f, 0.0f }, { extent, 4.0f, 0.0f });
+        double ns = TimeNs(2000, [&] { rope.OnRopeCollision(world.blocks, world.broadphase); });
+        benchSink = (int)rope.points.y[128];
+        printf("%8d %12.0f %12.1f", count, ns, ns / 256);
+        PrintGrowth(ns, previous);
+        previous = ns;
+    }
+}
+
+void BenchPlayerCollision() {
+    printf("\nPlayer::Update (ground and block collision + gravity)\n");
+    printf("%8s %12s %9s\n", "blocks", "ns/update", "growth");
+    srand(6);
+    double previous = 0.0;
+    for (int count : { 256, 4096, 65536 }) {
+        World world;
+        Terrain terrain;
+        float extent = MakeScene(world, terrain, count);
+        Player body({}, { 0.0f, 5.0f, 0.0f }, { 0.01f, 0.01f, 0.01f }); // physics only, no models
+
+        std::vector<Vector3> starts(1024);
+        for (Vector3& start : starts) start = { RandomRange(-extent, extent), RandomRange(0.0f, 12.0f), RandomRange(-extent, extent) };
+        int q = 0;
+        double ns = TimeNs(200000, [&] {
+            body.position = starts[q++ & 1023];
+            body.Update(world.blocks, world.broadphase, 1.0f / 120.0f);
+        });
+        benchSink = (int)body.position.y;
+        printf("%8d %12.0f", count, ns);
+        PrintGrowth(ns, previous);
+        previous = ns;
+    }
+}
+
+void BenchPlayerRotated() {
+    printf("\nPlayer dropped onto a 4-unit cube at the origin, after 1 s (AABB top would be the 2nd column)\n");
+    printf("%24s %10s %10s %10s\n", "case", "aabb top", "feet y", "grounded");
+    struct Case { const char* name; Vector3 rotation; Vector3 start; };
+    for (Case c : { Case{ "flat, center", { 0, 0, 0 }, { 0, 5, 0 } }, Case{ "yawed 45, center", { 0, 45, 0 }, { 0, 5, 0 } },
+        Case{ "yawed 45, aabb corner", { 0, 45, 0 }, { 2.3f, 5, 2.3f } }, Case{ "tilted 30, center", { 0, 0, 30 }, { 0, 5, 0 } } }) {
+        World world;
+        Block& block = world.AddBlock(Block({ 0, 0, 0 }, { 4, 4, 4 }, c.rotation));
+        float top = block.GetCollisionBox().max.y;
+        Player body({}, c.start, { 0.01f, 0.01f, 0.01f });
+        for (int step = 0; step < 120; step++) body.Update(world.blocks, world.broadphase, 1.0f / 120.0f);
+        printf("%24s %10.2f %10.2f %10s\n", c.name, top, body.position.y, body.IsGrounded() ? "yes" : "no");
+    }
+}
+
+void BenchPlayerCrowd() {
+    printf("\nPlayers walking through 4096 blocks for 2 s (controller step: sweep, slide, step-up, snap)\n");
+    printf("%8s %14s %10s %9s\n", "players", "ns/player-step", "inside", "growth");
+    srand(8);
+    World world;
+    Terrain terrain;
+    float extent = MakeScene(world, terrain, 4096);
+    double previous = 0.0;
+    for (int count : { 1, 16, 256 }) {
+        std::vector<std::unique_ptr<Player>> players;
+        for (int i = 0; i < count; i++) {
+            Vector3 start = { RandomRange(-extent, extent) * 0.9f, 12.0f, RandomRange(-extent, extent) * 0.9f };
+            players.push_back(std::make_unique<Player>(std::vector<const char*>{}, start, Vector3{ 0.01f, 0.01f, 0.01f }));
+        }
+        PlayerInput input;
+        input.moveDir = { 0.0f, 0.0f, 1.0f };
+        int steps = 0;
+        double ns = TimeNs(240, [&] {
+            input.cameraYaw = steps++ * 0.01f; // walk in slow circles
+            for (auto& player : players) {
+                player->PlayerController(input, 1.0f / 120.0f);
+                player->Update(world.blocks, world.broadphase, 1.0f / 120.0f);
+            }
+        }) / count;
+        int inside = 0;
+        for (auto& player : players) {
+            BoundingBox box = player->GetCollisionBox(player->position);
+            world.broadphase.Query(box, [&](int blockIndex) {
+                if (world.blocks[blockIndex].terrain == nullptr) inside += BoxBoxContact(box, world.blocks[blockIndex].GetBounds()).hit;
+                return true;
+            });
+        }
+        printf("%8d %14.0f %10d", count, ns, inside);
+        PrintGrowth(ns, previous);
+        previous = ns;
+    }
+}
+
+void BenchGrappleSwing() {
+    printf("\nPlayer swinging on a grapple, released level with the anchor, 10 s (World::Step)\n");
+    printf("%8s %12s %14s %14s %12s\n", "length", "ns/step", "far side x", "back side x", "max stretch");
+    for (float length : { 5.0f, 10.0f, 20.0f }) {
+        World world;
+        Player player({}, { length, 30.0f, 0.0f }, { 0.01f, 0.01f, 0.01f });
+        world.player = &player;
+        world.AddBlock(Block({ 0.0f, 30.0f, 0.0f }, { 1.0f, 1.0f, 1.0f }));
+        world.AttachRope(&world.blocks[0], 30);
+        Rope* rope = world.GetPlayerRope();
+        // Energy lost shows as turning points short of +-length, on the far side and on the way back
+        float farSide = 0.0f, backSide = -FLT_MAX, stretch = 0.0f;
+        int steps = 0;
+        double ns = TimeNs(1200, [&] {
+            world.Step(1.0f / 120.0f);
+            steps++;
+            farSide = fminf(farSide, player.position.x);
+            if (steps > 600) backSide = fmaxf(backSide, player.position.x);
+            stretch = fmaxf(stretch, Vector3Distance(player.position, rope->GetPoint(rope->numPoints - 1)) / rope->restLength);
+        });
+        printf("%8.0f %12.0f %14.2f %14.2f %12.4f\n", length, ns, farSide, backSide, stretch);
+    }
+}
+
+void BenchRopeReel() {
+    printf("\nReeling a rope attached outside minLength..maxLength (1..100)\n");
+    printf("%10s %10s %10s %10s\n", "attached", "reel", "length", "check");
+    struct Case { float attached, reel; bool shorter; };
+    for (Case c : { Case{ 150.0f, 1.0f, false }, Case{ 150.0f, -1.0f, true }, Case{ 99.5f, 1.0f, false },
+        Case{ 0.5f, -1.0f, false }, Case{ 0.5f, 1.0f, false } }) {
+        Rope rope;
+        rope.Init(10, { 0.0f, c.attached, 0.0f }, { 0.0f, 0.0f, 0.0f });
+        rope.Reel(c.reel);
+        // Paying out must never shorten the rope and hauling in never lengthen it
+        bool ok = c.reel > 0.0f ? rope.restLength >= c.attached : rope.restLength <= c.attached;
+        if (c.shorter) ok = ok && rope.restLength < c.attached;
+        printf("%10.1f %10.1f %10.1f %10s\n", c.attached, c.reel, rope.restLength, ok ? "ok" : "WRONG");
+    }
+}
+
+void BenchTessellation() {
+    printf("\nRope::Tessellate (Catmull-Rom, forward differenced), ns per rope\n");
+    printf("%8s %12s %12s %12s %12s %12s %9s\n", "points", "2 segs", "6 segs", "16 segs", "6 direct", "ns/vertex", "growth");
+    std::vector<Vector3> curve;
+    double previous = 0.0;
+    for (int count : { 16, 64, 256, 1024 }) {
+        Rope rope;
+        rope.Init(count, { 0.0f, 5.0f, 0.0f }, { count * 0.25f, 5.0f, 0.0f });
+        rope.adaptive = false;
+        rope.Update({ 0.0f, 5.0f, 0.0f }, { count * 0.25f, 5.0f, 0.0f }, 1.0f / 120.0f);
+        double ns[3];
+        int column = 0;
+        for (int segments : { 2, 6, 16 }) {
+            ns[column++] = TimeNs(2000000 / (count * segments), [&] { rope.Tessellate(0.5f, curve, segments); });
+        }
+        int vertices = (int)curve.size();
+        // Same curve evaluated with CatmullRom per vertex, for comparison
+        std::vector<Vector3> p(count + 2);
+        double directNs = TimeNs(2000000 / (count * 6), [&] {
+            for (int i = 0; i < count; i++) p[i + 1] = Vector3Lerp(rope.GetOldPoint(i), rope.GetPoint(i), 0.5f);
+            p[0] = Vector3Subtract(Vector3Scale(p[1], 2.0f), p[2]);
+            p[count + 1] = Vector3Subtract(Vector3Scale(p[count], 2.0f), p[count - 1]);
+            curve.clear();
+            for (int i = 1; i < count; i++) {
+                for (int j = 0; j < 6; j++) curve.push_back(CatmullRom(p[i - 1], p[i], p[i + 1], p[i + 2], j / 6.0f));
+            }
+            curve.push_back(p[count]);
+        });
+        benchSink = (int)curve.size() + vertices;
+        printf("%8d %12.0f %12.0f %12.0f %12.0f %12.1f", count, ns[0], ns[1], ns[2], directNs, ns[1] / ((count - 1) * 6 + 1));
+        PrintGrowth(ns[1], previous);
+        previous = ns[1];
+    }
+}
+
+void BenchRopeMesh() {
+    printf("\nRopeMesh::Append (tessellate + 8-sided tube with normals), per rope\n");
+    printf("%8s %12s %12s %12s %12s %9s\n", "points", "ns/rope", "vertices", "ns/vertex", "Mvert/s", "growth");
+    RopeMesh mesh;
+    double previous = 0.0;
+    for (int count : { 16, 64, 256, 1024 }) {
+        Rope rope;
+        rope.Init(count, { 0.0f, 5.0f, 0.0f }, { count * 0.2f, 5.0f, 0.0f }); // slack, so it sags
+        rope.adaptive = false;
+        for (int step = 0; step < 60; step++) rope.Update({ 0.0f, 5.0f, 0.0f }, { count * 0.2f, 5.0f, 0.0f }, 1.0f / 120.0f);
+        double ns = TimeNs(4000000 / (count * 6 * 9), [&] {
+            mesh.Clear();
+            mesh.Append(rope, 0.5f);
+        });
+        int vertices = mesh.GetVertexCount();
+        benchSink = vertices + mesh.GetTriangleCount();
+        printf("%8d %12.0f %12d %12.1f %12.1f", count, ns, vertices, ns / vertices, vertices / ns * 1000.0);
+        PrintGrowth(ns, previous);
+        previous = ns;
+    }
+
+    // Hundreds of ropes spill over into more 16-bit pages instead of being dropped
+    Rope rope;
+    rope.Init(50, { 0.0f, 5.0f, 0.0f }, { 10.0f, 5.0f, 0.0f });
+    mesh.Clear();
+    int appended = 0;
+    for (int i = 0; i < 256; i++) appended += mesh.Append(rope, 0.5f) ? 1 : 0;
+    bool indicesFit = true;
+    for (const RopeMesh::Page& page : mesh.pages) {
+        for (int i = 0; i < page.indexCount; i++) indicesFit &= mesh.indices[page.firstIndex + i] < page.vertexCount;
+    }
+    printf("  256 ropes of 50 points: %d appended, %d vertices in %d pages, indices %s\n", appended,
+        mesh.GetVertexCount(), mesh.GetPageCount(), indicesFit ? "in range" : "OUT OF RANGE");
+}
+
+void BenchPicking() {
+    printf("\nPickBlock (broadphase ray query + exact block/terrain test)\n");
+    printf("%8s %12s %8s %12s %9s\n", "blocks", "ns/pick", "hits", "x10 dir same", "growth");
+    srand(7);
+    double previous = 0.0;
+    for (int count : { 256, 4096, 65536 }) {
+        World world;
+        Terrain terrain;
+        float extent = MakeScene(world, terrain, count);
+        std::vector<Ray> rays(1024);
+        for (Ray& ray : rays) {
+            Vector3 eye = { RandomRange(-extent, extent), 25.0f, RandomRange(-extent, extent) };
+            Vector3 target = { eye.x + RandomRange(-20.0f, 20.0f), 0.0f, eye.z + RandomRange(-20.0f, 20.0f) };
+            ray = { eye, Vector3Normalize(Vector3Subtract(target, eye)) };
+        }
+        int hits = 0;
+        for (const Ray& ray : rays) hits += PickBlock(world.blocks, world.broadphase, ray) != nullptr;
+        // A longer direction must pick the same block at the same distance
+        int same = 0;
+        for (const Ray& ray : rays) {
+            float distance, scaledDistance;
+            Block* picked = PickBlock(world.blocks, world.broadphase, ray, &distance);
+            Block* scaled = PickBlock(world.blocks, world.broadphase, { ray.position, Vector3Scale(ray.direction, 10.0f) }, &scaledDistance);
+            same += picked == scaled && (picked == nullptr || fabsf(distance - scaledDistance) < 1e-3f);
+        }
+        int q = 0;
+        double ns = TimeNs(50000, [&] { benchSink = PickBlock(world.blocks, world.broadphase, rays[q++ & 1023]) != nullptr; });
+        printf("%8d %12.0f %7.0f%% %11.0f%%", count, ns, 100.0f * hits / 1024, 100.0f * same / 1024);
+        PrintGrowth(ns, previous);
+        previous = ns;
+    }
+}
+
+void BenchRopeWorld() {
+    printf("\nRopeWorld::Step, 50-point ropes over 4096 blocks (%d workers + caller)\n", JobSystem::Get().GetWorkerCount());
+    printf("%8s %12s %12s %12s %9s\n", "ropes", "serial ns", "parallel ns", "ns/rope", "speedup");
+    srand(8);
+    World world;
+    Terrain terrain;
+    float extent = MakeScene(world, terrain, 4096);
+    for (int count : { 1, 4, 16, 64, 256 }) {
+        RopeWorld ropes;
+        for (int i = 0; i < count; i++) {
+            Vector3 start = { RandomRange(-extent, extent), RandomRange(5.0f, 15.0f), RandomRange(-extent, extent) };
+            Vector3 end = { start.x + RandomRange(-12.0f, 12.0f), RandomRange(5.0f, 15.0f), start.z + RandomRange(-12.0f, 12.0f) };
+            ropes.Attach(RopeAnchor::AtPoint(start), RopeAnchor::AtPoint(end), world.blocks, { 0, 0, 0 }, 50);
+        }
+        int reps = std::max(20, 20000 / count);
+        ropes.parallel = false;
+        double serial = TimeNs(reps, [&] { ropes.Step(world.blocks, world.broadphase, { 0, 0, 0 }, 1.0f / 120.0f); });
+        ropes.parallel = true;
+        double parallel = TimeNs(reps, [&] { ropes.Step(world.blocks, world.broadphase, { 0, 0, 0 }, 1.0f / 120.0f); });
+        benchSink = (int)ropes.Get(0)->points.y[25];
+        printf("%8d %12.0f %12.0f %12.0f %8.2fx\n", count, serial, parallel, parallel / count, serial / parallel);
+    }
+}
+
+// Frames of 4096 blocks and a walking player with ropes strung around the
+// level. Main-thread work stands in for drawing: the render queue build.
+void BenchPipeline() {
+    printf("\nFramePipeline, 120 frames at 60 fps over 4096 blocks (%d workers + main)\n", JobSystem::Get().GetWorkerCount());
+    printf("%8s %12s %12s %12s %12s %9s %10s\n", "ropes", "sim ns", "draw ns", "serial ns", "piped ns", "speedup", "same path");
+    for (int count : { 0, 16, 64 }) {
+        double frameNs[2];
+        Vector3 finalPosition[2];
+        double simNs = 0.0, drawNs = 0.0;
+        for (int mode = 0; mode < 2; mode++) {
+            srand(9);
+            World world;
+            Terrain terrain;
+            float extent = MakeScene(world, terrain, 4096);
+            Player player({}, { 0.0f, 12.0f, 0.0f }, { 0.01f, 0.01f, 0.01f });
+            world.player = &player;
+            for (int i = 0; i < count; i++) {
+                Vector3 start = { RandomRange(-extent, extent), RandomRange(5.0f, 15.0f), RandomRange(-extent, extent) };
+                Vector3 end = { start.x + RandomRange(-12.0f, 12.0f), RandomRange(5.0f, 15.0f), start.z + RandomRange(-12.0f, 12.0f) };
+                world.ropes.Attach(RopeAnchor::AtPoint(start), RopeAnchor::AtPoint(end), world.blocks, { 0, 0, 0 }, 50);
+            }
+            FramePipeline pipeline(world);
+            pipeline.pipelined = mode == 1;
+            pipeline.Refresh();
+            RenderQueue queue;
+            InputFrame input;
+            input.frameTime = 1.0f / 60.0f;
+            input.held = INPUT_FORWARD;
+            int frame = 0;
+            frameNs[mode] = TimeNs(120, [&] {
+                input.cameraYaw = frame++ * 0.02f;
+                pipeline.Begin(input);
+                Camera3D camera = { Vector3Add(pipeline.Front().player.position, { 0, 10, -10 }), pipeline.Front().player.position, { 0, 1, 0 }, 90.0f, CAMERA_PERSPECTIVE };
+                queue.Build(world.blocks, ExtractFrustum(camera, 16.0f / 9.0f));
+                pipeline.Finish();
+            });
+            finalPosition[mode] = player.position;
+            if (mode == 0) {
+                // The two halves on their own, to show what overlapping them can save
+                simNs = TimeNs(120, [&] { pipeline.Begin(input); pipeline.Finish(); });
+                Camera3D camera = { { 0, 10, -10 }, { 0, 0, 0 }, { 0, 1, 0 }, 90.0f, CAMERA_PERSPECTIVE };
+                drawNs = TimeNs(120, [&] { queue.Build(world.blocks, ExtractFrustum(camera, 16.0f / 9.0f)); });
+            }
+            benchSink = queue.visibleCount + pipeline.Front().ropeCount;
+        }
+        bool same = memcmp(&finalPosition[0], &finalPosition[1], sizeof(Vector3)) == 0;
+        printf("%8d %12.0f %12.0f %12.0f %12.0f %8.2fx %10s\n", count, simNs, drawNs, frameNs[0], frameNs[1],
+            frameNs[0] / frameNs[1], same ? "yes" : "NO");
+    }
+
+    // A long load on every worker mustn't hold up the frame queued behind it
+    World world;
+    Terrain terrain;
+    MakeScene(world, terrain, 4096);
+    Player player({}, { 0.0f, 12.0f, 0.0f }, { 0.01f, 0.01f, 0.01f });
+    world.player = &player;
+    FramePipeline pipeline(world);
+    pipeline.Refresh();
+    InputFrame input;
+    input.frameTime = 1.0f / 60.0f;
+    JobCounter loads;
+    for (int i = 0; i < JobSystem::Get().GetWorkerCount(); i++) {
+        JobSystem::Get().RunBackground(loads, [] { std::this_thread::sleep_for(std::chrono::milliseconds(500)); });
+    }
+    double blockedNs = TimeNs(1, [&] { pipeline.Begin(input); pipeline.Finish(); });
+    JobSystem::Get().Wait(loads);
+    printf("  frame with a 500 ms load on every worker: %.0f us\n", blockedNs / 1000.0);
+}
+
+// Checks the folded blur kernels against the plain Gaussian they replace, by
+// blurring a noisy row both ways with linear filtering, and counts what the
+// bloom chain costs per pixel next to the old 3 x 14 tap neon shader
+void BenchBloom() {
+    printf("\nBloom blur kernels (1D, row of 4096 noisy texels)\n");
+    printf("%8s %8s %8s %8s %12s %12s %14s\n", "radius", "sigma", "taps", "fetches", "weight sum", "max error", "fetches/pixel");
+    std::vector<float> row(4096);
+    for (float& v : row) v = RandomRange(0.0f, 1.0f);
+    auto texel = [&](int i) { return row[i < 0 ? 0 : (i >= (int)row.size() ? (int)row.size() - 1 : i)]; };
+    auto linear = [&](float x) { int i = (int)floorf(x); float f = x - i; return texel(i) * (1.0f - f) + texel(i + 1) * f; };
+    struct Case { int radius; float sigma; };
+    for (Case c : { Case{ 2, 1.0f }, Case{ 4, 2.0f }, Case{ 6, 3.0f }, Case{ 8, 4.0f }, Case{ 14, 6.0f } }) {
+        BlurKernel kernel = MakeBlurKernel(c.radius, c.sigma);
+        float sum = kernel.weights[0];
+        for (int t = 1; t < kernel.GetTapCount(); t++) sum += 2.0f * kernel.weights[t];
+
+        float reference[15], total = 0.0f;
+        for (int k = 0; k <= c.radius; k++) {
+            reference[k] = expf(-(float)(k * k) / (2.0f * c.sigma * c.sigma));
+            total += k == 0 ? reference[k] : 2.0f * reference[k];
+        }
+        float maxError = 0.0f;
+        for (int i = 0; i < (int)row.size(); i++) {
+            float plain = texel(i) * reference[0] / total;
+            for (int k = 1; k <= c.radius; k++) plain += (texel(i + k) + texel(i - k)) * reference[k] / total;
+            float folded = texel(i) * kernel.weights[0];
+            for (int t = 1; t < kernel.GetTapCount(); t++) {
+                folded += (linear(i + kernel.offsets[t]) + linear(i - kernel.offsets[t])) * kernel.weights[t];
+            }
+            maxError = fmaxf(maxError, fabsf(plain - folded));
+        }
+        printf("%8d %8.1f %8d %8d %12.6f %12.2e %14.2f\n", c.radius, c.sigma, kernel.GetTapCount(), kernel.GetFetchCount(),
+            sum, maxError, Bloom::GetFetchesPerPixel(3, kernel));
+    }
+    printf("  old Neon.frag: 42 fetches/pixel; default chain (radius 4, 3 levels): %.2f\n",
+        Bloom::GetFetchesPerPixel(3, MakeBlurKernel(4, 2.0f)));
+}
+
+// Compiles the game's frame graph, with the bloom passes as the game adds
+// them, compositing into a target so that made-up full-screen effects can be
+// chained after it before it is presented. Checks that
+// no two targets sharing a slot are alive at once. Nothing is executed.
+void BenchRenderGraph() {
+    printf("\nRenderGraph compile, 1920x1080 scene (no GL; checks slot sharing)\n");
+    printf("%-22s %7s %9s %8s %7s %12s %12s %11s %6s\n", "graph", "passes", "run", "targets", "slots", "no reuse MB", "pooled MB", "compile ns", "safe");
+    Bloom bloom;
+    Outline outline;
+    RenderGraph graph;
+    auto nothing = [](RenderGraph&) {};
+    struct Case { const char* name; int extraEffects; bool bloomOn; };
+    for (Case c : { Case{ "game", 0, true }, Case{ "game, bloom off", 0, false }, Case{ "game + 2 effects", 2, true },
+        Case{ "game + 6 effects", 6, true } }) {
+        auto build = [&] {
+            graph.Reset();
+            TargetDesc full = { 1920, 1080 };
+            int scene = graph.AddTarget("Scene", full);
+            graph.AddPass("Scene", {}, scene, nothing);
+            outline.AddPasses(graph, scene, Camera3D{}, [] {});
+            int glow = bloom.AddPasses(graph, scene);
+            int color = graph.AddTarget("Composite", full);
+            graph.AddPass("Composite", { scene, glow }, color, nothing);
+            // Each effect reads the last one's output and keeps a mask of its own
+            for (int e = 0; e < c.extraEffects; e++) {
+                int mask = graph.AddTarget("Mask", { 1920, 1080, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE });
+                int next = graph.AddTarget("Effect", full);
+                graph.AddPass("Mask", { color }, mask, nothing, "Effects");
+                graph.AddPass("Effect", { color, mask }, next, nothing, "Effects");
+                color = next;
+            }
+            graph.AddPass("Present", { color }, RenderGraph::screen, nothing);
+            graph.AddPass("UI", {}, RenderGraph::screen, nothing);
+            graph.SetEnabled("Bloom", c.bloomOn);
+            graph.Compile();
+        };
+        double ns = TimeNs(20000, build);
+
+        int run = 0;
+        for (const RenderGraph::Pass& pass : graph.GetPasses()) run += pass.run ? 1 : 0;
+        size_t allBytes = 0, pooledBytes = 0;
+        for (const RenderGraph::Target& target : graph.GetTargets()) if (target.slot >= 0) allBytes += target.desc.GetBytes();
+        for (const TargetDesc& slot : graph.GetSlots()) pooledBytes += slot.GetBytes();
+        bool safe = true;
+        const std::vector<RenderGraph::Target>& targets = graph.GetTargets();
+        for (size_t a = 0; a < targets.size(); a++) {
+            for (size_t b = a + 1; b < targets.size(); b++) {
+                if (targets[a].slot < 0 || targets[a].slot != targets[b].slot) continue;
+                if (!(targets[a].desc == targets[b].desc)) safe = false;
+                if (targets[a].first <= targets[b].last && targets[b].first <= targets[a].last) safe = false;
+            }
+        }
+        printf("%-22s %7d %9d %8d %7d %12.1f %12.1f %11.0f %6s\n", c.name, (int)graph.GetPasses().size(), run,
+            (int)targets.size(), (int)graph.GetSlots().size(), allBytes / 1048576.0, pooledBytes / 1048576.0, ns, safe ? "yes" : "NO");
+    }
+}
+
+// Chunks TerrainQuadtree picks for a camera standing on the ground, every
+// chunk taken as loaded. Triangles are what the chunks' meshes hold, skirts
+// included, against one full-resolution mesh of the map. "holes" counts
+// visible full-resolution chunks no selected chunk covers, "overlaps" ones
+// covered twice; "height err" compares a leaf's vertices with
+// Terrain::GetHeight, which collision uses. "prepare us" is the worker half
+// of a heightmap load (quadtree and root mesh).
+void BenchTerrainChunks() {
+    printf("\nTerrain chunks, camera standing at the center looking along the ground\n");
+    printf("%8s %7s %7s %11s %9s %12s %12s %10s %11s %6s %9s %11s\n", "samples", "chunks", "levels", "prepare us",
+        "selected", "triangles", "full res", "select ns", "mesh us", "holes", "overlaps", "height err");
+    for (int samples : { 257, 1025, 2049, 4097 }) {
+        Terrain terrain;
+        MakeTerrain(terrain, samples);
+        TerrainBuild build;
+        double buildNs = TimeNs(3, [&] { build.Prepare(terrain); }); // on a worker in the game
+        TerrainQuadtree& quadtree = build.quadtree;
+        const std::vector<TerrainQuadtree::Node>& nodes = quadtree.GetNodes();
+
+        Camera3D camera = { { 0.0f, 8.0f, 0.0f }, { 0.0f, 6.0f, 30.0f }, { 0.0f, 1.0f, 0.0f }, 60.0f, CAMERA_PERSPECTIVE };
+        Visibility visibility;
+        visibility.Begin(camera, 16.0f / 9.0f);
+        std::vector<int> selected;
+        auto ready = [](int) { return true; };
+        auto request = [](int) {};
+        double selectNs = TimeNs(1000, [&] { quadtree.Select(visibility, selected, ready, request); });
+
+        int triangles = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int index : selected) triangles += BuildChunkGeometry(quadtree.GetSamples(index)).GetTriangleCount();
+        double meshUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / selected.size();
+
+        // Leaves each selected chunk covers, by cell position
+        int leavesX = (samples - 2) / quadtree.chunkCells + 1;
+        std::vector<int> covered(leavesX * leavesX, 0);
+        for (int index : selected) {
+            const TerrainQuadtree::Node& node = nodes[index];
+            int span = quadtree.GetSpan(node) / quadtree.chunkCells;
+            int lx = node.x0 / quadtree.chunkCells, lz = node.z0 / quadtree.chunkCells;
+            for (int z = lz; z < lz + span && z < leavesX; z++) {
+                for (int x = lx; x < lx + span && x < leavesX; x++) covered[x + z * leavesX]++;
+            }
+        }
+        int holes = 0, overlaps = 0, firstLeaf = -1;
+        for (int i = 0; i < (int)nodes.size(); i++) {
+            if (nodes[i].level != 0) continue;
+            if (firstLeaf < 0) firstLeaf = i;
+            int count = covered[nodes[i].x0 / quadtree.chunkCells + nodes[i].z0 / quadtree.chunkCells * leavesX];
+            if (count == 0 && visibility.ClassifyBox(quadtree.GetBounds(nodes[i]), false) >= 0) holes++;
+            if (count > 1) overlaps++;
+        }
+
+        ChunkGeometry leaf = BuildChunkGeometry(quadtree.GetSamples(firstLeaf));
+        int gridVertices = (quadtree.chunkCells + 1) * (quadtree.chunkCells + 1);
+        float heightError = 0.0f;
+        for (int v = 0; v < gridVertices && v < leaf.GetVertexCount(); v++) {
+            const float* p = &leaf.vertices[v * 3];
+            heightError = fmaxf(heightError, fabsf(p[1] - terrain.GetHeight(p[0], p[2])));
+        }
+        long long fullRes = 2ll * (samples - 1) * (samples - 1);
+        printf("%8d %7d %7d %11.0f %9d %12d %12lld %10.0f %11.1f %6d %9d %11.2e\n", samples, (int)nodes.size(),
+            quadtree.GetLevelCount(), buildNs / 1000.0, (int)selected.size(), triangles, fullRes, selectNs, meshUs,
+            holes, overlaps, heightError);
+    }
+}
+
+// A scripted minute of play at a jittery ~60 fps: running, turning, jumping,
+// and swinging from the first wall. Positions are filled in by playing it
+// once, as the game does while recording.
+InputLog MakeSession(const Terrain& heights, int frames) {
+    InputLog log;
+    unsigned int seed = 12345;
+    for (int i = 0; i < frames; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        InputFrame frame;
+        frame.frameTime = (1.0f / 60.0f) * (0.8f + 0.4f * (seed >> 8) / 16777216.0f);
+        static const InputButton square[] = { INPUT_FORWARD, INPUT_LEFT, INPUT_BACK, INPUT_RIGHT };
+        frame.held = square[(i / 120) % 4];
+        if (i % 90 == 0) frame.pressed |= INPUT_JUMP;
+        frame.cameraYaw = 0.0005f * i;
+        if (i == 900) frame.attachBlock = 0;
+        log.frames.push_back(frame);
+    }
+    ReplayReport recording = RunReplay(log, heights);
+    for (int i = 0; i < frames; i++) log.frames[i].playerPosition = recording.trajectory[i];
+    return log;
+}
+
+void BenchReplay() {
+    printf("\nRecorded session replayed headlessly (3600 frames)\n");
+    Terrain heights;
+    MakeTerrain(heights, 256);
+    InputLog log = MakeSession(heights, 3600);
+    const char* path = "bench_session.grin";
+    InputLog loaded;
+    if (!log.Save(path) || !loaded.Load(path)) {
+        printf("  can't round-trip %s\n", path);
+        return;
+    }
+    remove(path);
+    ReplayReport first = RunReplay(loaded, heights);
+    ReplayReport second = RunReplay(loaded, heights);
+    first.Print();
+    printf("  second run trajectory %08x, %s\n", second.checksum, second.checksum == first.checksum ? "identical" : "DIFFERENT");
+}
+
+struct Benchmark {
+    const char* name;
+    void (*run)();
+};
+
+// Pass name fragments to run only the matching benchmarks, e.g. "grapple_bench rope picking"
+int main(int argc, char** argv) {
+    Benchmark benchmarks[] = {
+        { "rope-solver", BenchRopeSolver },
+        { "broadphase", BenchBroadphase },
+        { "terrain", BenchTerrain },
+        { "render-queue", BenchRenderQueue },
+        { "transforms", BenchTransforms },
+        { "animation", BenchAnimation },
+        { "rope-update", BenchRopeUpdate },
+        { "rope-collision", BenchRopeCollision },
+        { "rope-adaptive", BenchRopeAdaptive },
+        { "rope-contact", BenchRopeContact },
+        { "player-collision", BenchPlayerCollision },
+        { "player-rotated", BenchPlayerRotated },
+        { "player-crowd", BenchPlayerCrowd },
+        { "grapple-swing", BenchGrappleSwing },
+        { "rope-reel", BenchRopeReel },
+        { "tessellation", BenchTessellation },
+        { "rope-mesh", BenchRopeMesh },
+        { "picking", BenchPicking },
+        { "rope-world", BenchRopeWorld },
+        { "replay", BenchReplay },
+        { "pipeline", BenchPipeline },
+        { "bloom", BenchBloom },
+        { "render-graph", BenchRenderGraph },
+        { "terrain-chunks", BenchTerrainChunks },
+    };
+    // grapple_bench --replay session.grin [frames.csv] replays a log recorded
+    // with "Grappling Hook --record"; run it from the repo root for the heightmap
+    if (argc >= 3 && strcmp(argv[1], "--replay") == 0) {
+        InputLog log;
+        Terrain heights;
+        if (!log.Load(argv[2])) {
+            printf("Can't read input log %s\n", argv[2]);
+            return 1;
+        }
+        if (!LoadLevelHeights(heights)) {
+            printf("Can't load %s\n", levelHeightmap);
+            return 1;
+        }
+        ReplayReport report = RunReplay(log, heights);
+        report.Print();
+        if (argc >= 4 && !report.WriteCsv(argv[3])) printf("Can't write %s\n", argv[3]);
+        return report.divergedFrame < 0 ? 0 : 1;
+    }
+    for (const Benchmark& benchmark : benchmarks) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) selected |= strstr(benchmark.name, argv[i]) != nullptr;
+        if (selected) benchmark.run();
+    }
+    return 0;
+}
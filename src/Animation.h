@@ -0,0 +1,152 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include <vector>
+#include <cmath>
+
+// translate * rotate * scale for one bone, built straight from the quaternion
+Matrix TransformToMatrix(const Transform& t) {
+    Quaternion q = t.rotation;
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    Matrix m;
+    m.m0 = (1.0f - 2.0f * (yy + zz)) * t.scale.x;
+    m.m1 = 2.0f * (xy + wz) * t.scale.x;
+    m.m2 = 2.0f * (xz - wy) * t.scale.x;
+    m.m4 = 2.0f * (xy - wz) * t.scale.y;
+    m.m5 = (1.0f - 2.0f * (xx + zz)) * t.scale.y;
+    m.m6 = 2.0f * (yz + wx) * t.scale.y;
+    m.m8 = 2.0f * (xz + wy) * t.scale.z;
+    m.m9 = 2.0f * (yz - wx) * t.scale.z;
+    m.m10 = (1.0f - 2.0f * (xx + yy)) * t.scale.z;
+    m.m12 = t.translation.x;
+    m.m13 = t.translation.y;
+    m.m14 = t.translation.z;
+    m.m3 = 0.0f; m.m7 = 0.0f; m.m11 = 0.0f; m.m15 = 1.0f;
+    return m;
+}
+
+// Lerp position/scale, normalized lerp rotation along the shorter arc. For the
+// small steps between neighbouring frames or during a short fade, nlerp is
+// indistinguishable from slerp and much cheaper.
+Transform BlendTransform(const Transform& a, const Transform& b, float t) {
+    Quaternion qb = b.rotation;
+    float dot = a.rotation.x * qb.x + a.rotation.y * qb.y + a.rotation.z * qb.z + a.rotation.w * qb.w;
+    if (dot < 0.0f) qb = { -qb.x, -qb.y, -qb.z, -qb.w };
+
+    Transform out;
+    out.translation = Vector3Lerp(a.translation, b.translation, t);
+    out.scale = Vector3Lerp(a.scale, b.scale, t);
+    out.rotation = QuaternionNormalize(QuaternionLerp(a.rotation, qb, t));
+    return out;
+}
+
+// Sampled poses of one clip at a fixed rate (subSamples per source frame),
+// filled on first use. Every character playing the clip shares the samples,
+// so a crowd costs one interpolation per sample instead of one per character.
+class PoseCache {
+public:
+    const ModelAnimation* clip = nullptr;
+    int subSamples = 2;
+
+    void Init(const ModelAnimation* animation, int samplesPerFrame = 2) {
+        clip = animation;
+        subSamples = samplesPerFrame;
+        int slots = GetSampleCount();
+        poses.assign((size_t)slots * (clip ? clip->boneCount : 0), Transform{});
+        filled.assign(slots, 0);
+    }
+
+    int GetSampleCount() const { return clip ? clip->frameCount * subSamples : 0; }
+    int GetBoneCount() const { return clip ? clip->boneCount : 0; }
+
+    // Slot for a time measured in source frames, wrapped to the clip length
+    int SampleIndex(float frame) const {
+        int slots = GetSampleCount();
+        if (slots == 0) return 0;
+        int slot = (int)floorf(frame * subSamples) % slots;
+        return slot < 0 ? slot + slots : slot;
+    }
+
+    // boneCount transforms, valid until the cache is re-initialized
+    const Transform* Sample(int slot) {
+        const Transform* pose = &poses[(size_t)slot * clip->boneCount];
+        if (!filled[slot]) {
+            Fill(slot);
+            filled[slot] = 1;
+        }
+        return pose;
+    }
+
+private:
+    std::vector<Transform> poses;      // slot-major, boneCount per slot
+    std::vector<unsigned char> filled;
+
+    void Fill(int slot) {
+        int frame = slot / subSamples;
+        float t = (float)(slot % subSamples) / subSamples;
+        int next = (frame + 1) % clip->frameCount;
+        const Transform* a = clip->framePoses[frame];
+        const Transform* b = clip->framePoses[next];
+        Transform* out = &poses[(size_t)slot * clip->boneCount];
+        for (int bone = 0; bone < clip->boneCount; bone++) {
+            out[bone] = t == 0.0f ? a[bone] : BlendTransform(a[bone], b[bone], t);
+        }
+    }
+};
+
+// Inverse bind matrix per bone; skin[b] = inverse(bind[b]) then pose[b]
+std::vector<Matrix> GetInverseBindMatrices(const Model& model) {
+    std::vector<Matrix> inverse(model.boneCount);
+    for (int bone = 0; bone < model.boneCount; bone++) {
+        inverse[bone] = MatrixInvert(TransformToMatrix(model.bindPose[bone]));
+    }
+    return inverse;
+}
+
+void ComputeSkinMatrices(const Transform* pose, const std::vector<Matrix>& inverseBind, std::vector<Matrix>& skin) {
+    skin.resize(inverseBind.size());
+    for (size_t bone = 0; bone < skin.size(); bone++) {
+        skin[bone] = MatrixMultiply(inverseBind[bone], TransformToMatrix(pose[bone]));
+    }
+}
+
+// Linear blend skinning of vertices [first, last) into outVertices/outNormals
+// (3 floats per vertex). Only touches CPU memory, so it can run on any thread.
+void SkinVertices(const Mesh& mesh, const Matrix* skin, float* outVertices, float* outNormals, int first, int last) {
+    for (int v = first; v < last; v++) {
+        const float* p = &mesh.vertices[v * 3];
+        const float* n = mesh.normals ? &mesh.normals[v * 3] : nullptr;
+        float px = 0, py = 0, pz = 0;
+        float nx = 0, ny = 0, nz = 0;
+        for (int j = 0; j < 4; j++) {
+            float w = mesh.boneWeights[v * 4 + j];
+            if (w == 0.0f) continue;
+            const Matrix& m = skin[mesh.boneIds[v * 4 + j]];
+            px += w * (m.m0 * p[0] + m.m4 * p[1] + m.m8 * p[2] + m.m12);
+            py += w * (m.m1 * p[0] + m.m5 * p[1] + m.m9 * p[2] + m.m13);
+            pz += w * (m.m2 * p[0] + m.m6 * p[1] + m.m10 * p[2] + m.m14);
+            if (n) {
+                nx += w * (m.m0 * n[0] + m.m4 * n[1] + m.m8 * n[2]);
+                ny += w * (m.m1 * n[0] + m.m5 * n[1] + m.m9 * n[2]);
+                nz += w * (m.m2 * n[0] + m.m6 * n[1] + m.m10 * n[2]);
+            }
+        }
+        outVertices[v * 3] = px;
+        outVertices[v * 3 + 1] = py;
+        outVertices[v * 3 + 2] = pz;
+        if (n && outNormals) {
+            float len = sqrtf(nx * nx + ny * ny + nz * nz);
+            if (len > 0.0f) len = 1.0f / len;
+            outNormals[v * 3] = nx * len;
+            outNormals[v * 3 + 1] = ny * len;
+            outNormals[v * 3 + 2] = nz * len;
+        }
+    }
+}
+
+bool IsSkinned(const Mesh& mesh) {
+    return mesh.boneIds && mesh.boneWeights && mesh.vertices;
+}
@@ -0,0 +1,227 @@
+#pragma once
+#include "raylib.h"
+#include "Animation.h"
+#include "Streaming.h"
+#include "Profiler.h"
+#include "Log.h"
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <mutex>
+#include <cstdio>
+#include <cstring>
+
+// Everything loaded from one model file, plus the data derived from it that
+// all instances can share. Per-instance state (clock, skin matrices, skinned
+// vertices) lives in Animator.
+struct ModelAsset {
+    std::string path;
+    Model model = { 0 };
+    ModelAnimation* animations = nullptr;
+    int animationCount = 0;
+    PoseCache poseCache;               // samples of the first clip
+    std::vector<Matrix> inverseBind;
+    BoundingBox bounds = { 0 };        // bind pose, model space
+    const void* uploadedBy = nullptr;  // instance whose skinned vertices are in the GPU buffers
+    int refCount = 0;
+    bool ready = false;                // false while streaming; nothing above is valid yet
+
+    bool HasClip() const { return ready && animations && animationCount > 0; }
+};
+
+// Reference-counted models keyed by path. The first Acquire loads the file,
+// later ones share it, and the last Release unloads it. Main thread only.
+class AssetCache {
+public:
+    static AssetCache& Instance() {
+        static AssetCache cache;
+        return cache;
+    }
+
+    ModelAsset* AcquireModel(const std::string& path) {
+        ModelAsset* asset = Find(path);
+        if (asset) return asset;
+
+        asset = Insert(path);
+        ParseModelFile(*asset);
+        UploadModelFile(*asset);
+        return asset;
+    }
+
+    // Returns at once with an asset that isn't ready yet. The file reads and
+    // animation parsing happen on a worker; LoadModel runs in the streamer's
+    // upload step because it creates GL buffers and textures.
+    ModelAsset* AcquireModelAsync(const std::string& path, AssetStreamer& streamer) {
+        ModelAsset* asset = Find(path);
+        if (asset) return asset;
+
+        asset = Insert(path);
+        streamer.Load([asset] { ParseModelFile(*asset); }, [this, asset] {
+            UploadModelFile(*asset);
+            if (asset->refCount == 0) Unload(asset); // released while it was loading
+        });
+        return asset;
+    }
+
+    void Release(ModelAsset* asset) {
+        if (!asset || --asset->refCount > 0) return;
+        if (asset->ready) Unload(asset);
+    }
+
+    int GetModelCount() const { return (int)models.size(); }
+
+private:
+    std::unordered_map<std::string, std::unique_ptr<ModelAsset>> models;
+
+    AssetCache() {
+        SetLoadFileDataCallback(ServeFile);
+    }
+
+    ModelAsset* Find(const std::string& path) {
+        auto found = models.find(path);
+        if (found == models.end()) return nullptr;
+        found->second->refCount++;
+        return found->second.get();
+    }
+
+    ModelAsset* Insert(const std::string& path) {
+        std::unique_ptr<ModelAsset> asset = std::make_unique<ModelAsset>();
+        asset->path = path;
+        asset->refCount = 1;
+        ModelAsset* result = asset.get();
+        models[path] = std::move(asset);
+        return result;
+    }
+
+    void Unload(ModelAsset* asset) {
+        UnloadModel(asset->model);
+        if (asset->animations) UnloadModelAnimations(asset->animations, asset->animationCount);
+        LOG("Asset unloaded: %s\n", asset->path.c_str());
+        models.erase(asset->path);
+    }
+
+    // raylib parses the file once in LoadModelAnimations and again in LoadModel.
+    // Both read it through LoadFileData, so the bytes are read from disk once,
+    // kept here between the two loads, and served from memory. A .gltf's
+    // external buffers and images are read along with it, so LoadModel on the
+    // main thread never waits on the disk.
+    struct PreloadedFiles {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<std::vector<unsigned char>>> files;
+        std::unordered_map<std::string, std::vector<std::string>> groups; // model path -> every file read for it
+    };
+
+    static PreloadedFiles& Preloaded() {
+        static PreloadedFiles preloaded;
+        return preloaded;
+    }
+
+    static void Preload(const std::string& path) {
+        std::vector<std::string> group = { path };
+        std::vector<std::shared_ptr<std::vector<unsigned char>>> contents(1, std::make_shared<std::vector<unsigned char>>());
+        if (!ReadFileBytes(path.c_str(), *contents[0])) contents[0] = nullptr;
+        size_t dot = path.find_last_of('.');
+        if (contents[0] && dot != std::string::npos && path.compare(dot, std::string::npos, ".gltf") == 0) {
+            size_t slash = path.find_last_of("/\\");
+            std::string directory = slash == std::string::npos ? "." : path.substr(0, slash);
+            // raylib asks for buffers and images as "<directory>/<uri>"
+            for (const std::string& uri : FindFileUris(*contents[0])) {
+                std::shared_ptr<std::vector<unsigned char>> bytes = std::make_shared<std::vector<unsigned char>>();
+                group.push_back(directory + "/" + uri);
+                contents.push_back(ReadFileBytes(group.back().c_str(), *bytes) ? bytes : nullptr);
+            }
+        }
+
+        PreloadedFiles& preloaded = Preloaded();
+        std::lock_guard<std::mutex> lock(preloaded.mutex);
+        for (size_t i = 0; i < group.size(); i++) {
+            if (contents[i]) preloaded.files[group[i]] = contents[i];
+        }
+        preloaded.groups[path] = group;
+    }
+
+    static void Forget(const std::string& path) {
+        PreloadedFiles& preloaded = Preloaded();
+        std::lock_guard<std::mutex> lock(preloaded.mutex);
+        auto group = preloaded.groups.find(path);
+        if (group == preloaded.groups.end()) return;
+        for (const std::string& file : group->second) preloaded.files.erase(file);
+        preloaded.groups.erase(group);
+    }
+
+    // The "uri" strings of a glTF's JSON that name files rather than embed
+    // data. A plain scan, not a JSON parser: only the values are needed.
+    static std::vector<std::string> FindFileUris(const std::vector<unsigned char>& json) {
+        std::vector<std::string> uris;
+        std::string text(json.begin(), json.end());
+        for (size_t at = text.find("\"uri\""); at != std::string::npos; at = text.find("\"uri\"", at + 1)) {
+            size_t open = text.find('"', text.find(':', at + 5));
+            if (open == std::string::npos) break;
+            std::string uri;
+            size_t i = open + 1;
+            for (; i < text.size() && text[i] != '"'; i++) {
+                if (text[i] == '\\' && i + 1 < text.size()) i++; // JSON escapes such as \/
+                uri += text[i];
+            }
+            if (!uri.empty() && uri.compare(0, 5, "data:") != 0) uris.push_back(uri);
+            at = i;
+        }
+        return uris;
+    }
+
+    static bool ReadFileBytes(const char* fileName, std::vector<unsigned char>& out) {
+        FILE* file = fopen(fileName, "rb");
+        if (!file) return false;
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        out.resize(size > 0 ? size : 0);
+        size_t read = size > 0 ? fread(out.data(), 1, out.size(), file) : 0;
+        fclose(file);
+        return read == out.size();
+    }
+
+    // Stands in for every LoadFileData call, from any thread. raylib frees what
+    // this returns, so hand out a MemAlloc'd copy.
+    static unsigned char* ServeFile(const char* fileName, int* dataSize) {
+        *dataSize = 0;
+        std::shared_ptr<std::vector<unsigned char>> bytes;
+        {
+            PreloadedFiles& preloaded = Preloaded();
+            std::lock_guard<std::mutex> lock(preloaded.mutex);
+            auto found = preloaded.files.find(fileName);
+            if (found != preloaded.files.end()) bytes = found->second;
+        }
+        if (!bytes) {
+            bytes = std::make_shared<std::vector<unsigned char>>();
+            if (!ReadFileBytes(fileName, *bytes)) return nullptr;
+        }
+        unsigned char* copy = (unsigned char*)MemAlloc((unsigned int)bytes->size());
+        if (!copy) return nullptr;
+        memcpy(copy, bytes->data(), bytes->size());
+        *dataSize = (int)bytes->size();
+        return copy;
+    }
+
+    // CPU only, safe on a worker
+    static void ParseModelFile(ModelAsset& asset) {
+        PROFILE_ZONE("Asset parse");
+        Preload(asset.path);
+        asset.animations = LoadModelAnimations(asset.path.c_str(), &asset.animationCount);
+        if (asset.animations && asset.animationCount > 0) asset.poseCache.Init(&asset.animations[0]);
+    }
+
+    // Main thread: LoadModel uploads meshes and textures. raylib has no
+    // CPU-only model loader, so its glTF parse and image decoding happen here
+    // too; every file they read is already in memory.
+    static void UploadModelFile(ModelAsset& asset) {
+        PROFILE_ZONE("Asset upload");
+        asset.model = LoadModel(asset.path.c_str());
+        Forget(asset.path);
+        asset.inverseBind = GetInverseBindMatrices(asset.model);
+        asset.bounds = GetModelBoundingBox(asset.model);
+        asset.ready = true;
+        LOG("Asset loaded: %s | Anim count: %d\n", asset.path.c_str(), asset.animationCount);
+    }
+};
@@ -0,0 +1,201 @@
+#pragma once
+#include "raylib.h"
+#include "RenderGraph.h"
+#include <cmath>
+#include <vector>
+
+// One side of a symmetric Gaussian, folded for bilinear sampling: each tap
+// after the center reads between two texels, so one fetch covers both of
+// them. Tap i is read at +offsets[i] and -offsets[i] texels with weights[i];
+// the center is read once. Weights over both sides add up to 1.
+struct BlurKernel {
+    static const int maxTaps = 8; // per side, must match Blur.frag
+
+    std::vector<float> offsets;
+    std::vector<float> weights;
+
+    int GetTapCount() const { return (int)offsets.size(); }
+    int GetFetchCount() const { return 2 * GetTapCount() - 1; } // per pixel per direction
+};
+
+// Texels radius out on each side, capped to what fits in maxTaps folded taps
+BlurKernel MakeBlurKernel(int radius, float sigma) {
+    int maxRadius = 2 * (BlurKernel::maxTaps - 1);
+    radius = radius < 0 ? 0 : (radius > maxRadius ? maxRadius : radius);
+    std::vector<float> discrete(radius + 1);
+    float total = 0.0f;
+    for (int i = 0; i <= radius; i++) {
+        discrete[i] = expf(-(float)(i * i) / (2.0f * sigma * sigma));
+        total += i == 0 ? discrete[i] : 2.0f * discrete[i];
+    }
+    for (float& w : discrete) w /= total;
+
+    BlurKernel kernel;
+    kernel.offsets.push_back(0.0f);
+    kernel.weights.push_back(discrete[0]);
+    for (int i = 1; i <= radius; i += 2) {
+        float a = discrete[i];
+        float b = i + 1 <= radius ? discrete[i + 1] : 0.0f;
+        kernel.offsets.push_back((i * a + (i + 1) * b) / (a + b));
+        kernel.weights.push_back(a + b);
+    }
+    return kernel;
+}
+
+// Glow around the bright parts of the frame, as passes on a RenderGraph. The
+// bright pass writes a half-size copy of the scene, which is shrunk into a
+// chain of smaller targets, each blurred with a separable Gaussian
+// (horizontally into a scratch target, then vertically back). The chain is
+// added back up into its largest level, which Composite draws over the scene.
+// All of it switches with the "Bloom" toggle.
+class Bloom {
+public:
+    float threshold = 0.7f;     // luminance where glow starts
+    float knee = 0.1f;          // fades in over threshold +- knee instead of cutting off
+    float intensity = 0.5f;
+    Vector4 color = { 0.0f, 1.0f, 0.0f, 1.0f }; // tints the glow
+    int levels = 3;             // blurred targets at 1/4, 1/8, 1/16 ... resolution
+    int blurRadius = 4;         // texels at each level
+    float blurSigma = 2.0f;
+
+    // Shaders and blur weights; needs the GL context
+    void Load() {
+        Unload();
+        kernel = MakeBlurKernel(blurRadius, blurSigma);
+        brightShader = LoadShader(0, "src/Bright.frag");
+        blurShader = LoadShader(0, "src/Blur.frag");
+        compositeShader = LoadShader(0, "src/Neon.frag");
+        thresholdLoc = GetShaderLocation(brightShader, "threshold");
+        kneeLoc = GetShaderLocation(brightShader, "knee");
+        resolutionLoc = GetShaderLocation(blurShader, "resolution");
+        directionLoc = GetShaderLocation(blurShader, "direction");
+        bloomLoc = GetShaderLocation(compositeShader, "bloom");
+        colorLoc = GetShaderLocation(compositeShader, "neonColor");
+        intensityLoc = GetShaderLocation(compositeShader, "glowIntensity");
+
+        // The kernel doesn't change between frames; uniforms keep their values
+        int tapCount = kernel.GetTapCount();
+        SetShaderValue(blurShader, GetShaderLocation(blurShader, "tapCount"), &tapCount, SHADER_UNIFORM_INT);
+        SetShaderValueV(blurShader, GetShaderLocation(blurShader, "offsets"), kernel.offsets.data(), SHADER_UNIFORM_FLOAT, tapCount);
+        SetShaderValueV(blurShader, GetShaderLocation(blurShader, "weights"), kernel.weights.data(), SHADER_UNIFORM_FLOAT, tapCount);
+        loaded = true;
+    }
+
+    void Unload() {
+        if (!loaded) return;
+        UnloadShader(brightShader);
+        UnloadShader(blurShader);
+        UnloadShader(compositeShader);
+        loaded = false;
+    }
+
+    // Adds the passes that build the glow from scene and returns the target
+    // holding it. The passes only run if something reads that target.
+    int AddPasses(RenderGraph& graph, int scene) {
+        TargetDesc desc = graph.GetDesc(scene);
+        desc.width /= 2;
+        desc.height /= 2;
+        if (desc.width < 1 || desc.height < 1) return graph.AddTarget("Bloom", desc);
+        int bright = graph.AddTarget("Bloom bright", desc);
+        graph.AddPass("Bloom bright", { scene }, bright, [this, scene, desc](RenderGraph& g) {
+            SetShaderValue(brightShader, thresholdLoc, &threshold, SHADER_UNIFORM_FLOAT);
+            SetShaderValue(brightShader, kneeLoc, &knee, SHADER_UNIFORM_FLOAT);
+            // Bilinear at half size averages each 2x2 block in one fetch
+            BeginShaderMode(brightShader);
+            Blit(g.GetTexture(scene), desc);
+            EndShaderMode();
+        }, "Bloom");
+
+        std::vector<int> chain;
+        int previous = bright;
+        for (int i = 0; i < levels; i++) {
+            desc.width /= 2;
+            desc.height /= 2;
+            if (desc.width < 1 || desc.height < 1) break;
+            int level = graph.AddTarget("Bloom level", desc);
+            int scratch = graph.AddTarget("Bloom scratch", desc);
+            graph.AddPass("Bloom shrink", { previous }, level, [previous, desc](RenderGraph& g) {
+                Blit(g.GetTexture(previous), desc);
+            }, "Bloom");
+            graph.AddPass("Bloom blur", { level }, scratch, [this, level, desc](RenderGraph& g) {
+                BlurPass(g.GetTexture(level), desc, { 1.0f, 0.0f });
+            }, "Bloom");
+            graph.AddPass("Bloom blur", { scratch }, level, [this, scratch, desc](RenderGraph& g) {
+                BlurPass(g.GetTexture(scratch), desc, { 0.0f, 1.0f });
+            }, "Bloom");
+            chain.push_back(level);
+            previous = level;
+        }
+        if (chain.empty()) return bright;
+
+        // Smaller levels carry the wide part of the glow; fold them into chain[0]
+        for (int i = (int)chain.size() - 1; i > 0; i--) {
+            int source = chain[i], dest = chain[i - 1];
+            TargetDesc destDesc = graph.GetDesc(dest);
+            graph.AddPass("Bloom add", { source, dest }, dest, [source, destDesc](RenderGraph& g) {
+                BeginBlendMode(BLEND_ADDITIVE);
+                Blit(g.GetTexture(source), destDesc);
+                EndBlendMode();
+            }, "Bloom");
+        }
+        levelCount = (int)chain.size();
+        return chain[0];
+    }
+
+    // Draws scene with the glow added over width x height of the current target
+    void Composite(const RenderGraph& graph, int scene, int glow, int width, int height) {
+        Texture2D source = graph.GetTexture(scene);
+        Rectangle flipped = { 0, 0, (float)source.width, (float)-source.height };
+        if (!graph.IsAvailable(glow)) {
+            DrawTexturePro(source, flipped, { 0, 0, (float)width, (float)height }, { 0, 0 }, 0.0f, WHITE);
+            return;
+        }
+        float strength = intensity / (float)levelCount; // levels were summed
+        SetShaderValue(compositeShader, colorLoc, &color, SHADER_UNIFORM_VEC4);
+        SetShaderValue(compositeShader, intensityLoc, &strength, SHADER_UNIFORM_FLOAT);
+        BeginShaderMode(compositeShader);
+        SetShaderValueTexture(compositeShader, bloomLoc, graph.GetTexture(glow));
+        DrawTexturePro(source, flipped, { 0, 0, (float)width, (float)height }, { 0, 0 }, 0.0f, WHITE);
+        EndShaderMode();
+    }
+
+    // Texture fetches per full-resolution pixel, counting every pass
+    static float GetFetchesPerPixel(int levels, const BlurKernel& kernel) {
+        float area = 0.25f;             // the half-size bright pass
+        float fetches = area;
+        for (int i = 1; i <= levels; i++) {
+            area *= 0.25f;
+            fetches += area * (1 + 2 * kernel.GetFetchCount()); // shrink, then blur both ways
+            if (i > 1) fetches += area * 4.0f;                  // added into the level above
+        }
+        return fetches + 2.0f;          // the composite reads scene and glow
+    }
+
+private:
+    BlurKernel kernel;
+    int levelCount = 1;         // blurred levels the last AddPasses made
+    Shader brightShader = { 0 };
+    Shader blurShader = { 0 };
+    Shader compositeShader = { 0 };
+    int thresholdLoc = -1, kneeLoc = -1;
+    int resolutionLoc = -1, directionLoc = -1;
+    int bloomLoc = -1, colorLoc = -1, intensityLoc = -1;
+    bool loaded = false;
+
+    // Stretches source over the bound target. Render textures are stored
+    // upside down, so the source is flipped, which leaves the target stored
+    // the same way.
+    static void Blit(Texture2D source, const TargetDesc& dest) {
+        DrawTexturePro(source, { 0, 0, (float)source.width, (float)-source.height },
+            { 0, 0, (float)dest.width, (float)dest.height }, { 0, 0 }, 0.0f, WHITE);
+    }
+
+    void BlurPass(Texture2D source, const TargetDesc& dest, Vector2 direction) {
+        Vector2 resolution = { (float)source.width, (float)source.height };
+        SetShaderValue(blurShader, resolutionLoc, &resolution, SHADER_UNIFORM_VEC2);
+        SetShaderValue(blurShader, directionLoc, &direction, SHADER_UNIFORM_VEC2);
+        BeginShaderMode(blurShader);
+        Blit(source, dest);
+        EndShaderMode();
+    }
+};
@@ -0,0 +1,30 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec2 resolution;    // Size of texture0 in texels
+uniform vec2 direction;     // (1, 0) blurs horizontally, (0, 1) vertically
+uniform int tapCount;       // Taps on each side, center included
+uniform float offsets[8];   // In texels, from MakeBlurKernel (Bloom.h)
+uniform float weights[8];
+
+// Output fragment color
+out vec4 finalColor;
+
+// One direction of a separable Gaussian. Offsets fall between texels, so
+// bilinear filtering reads two of them with each fetch.
+void main()
+{
+    vec2 texelStep = direction / resolution;
+    vec3 sum = texture(texture0, fragTexCoord).rgb * weights[0];
+    for (int i = 1; i < tapCount; i++)
+    {
+        sum += texture(texture0, fragTexCoord + texelStep * offsets[i]).rgb * weights[i];
+        sum += texture(texture0, fragTexCoord - texelStep * offsets[i]).rgb * weights[i];
+    }
+    finalColor = vec4(sum, 1.0);
+}
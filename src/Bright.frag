@@ -0,0 +1,22 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform float threshold;    // Luminance where the glow starts
+uniform float knee;         // Fades in over threshold +- knee
+
+// Output fragment color
+out vec4 finalColor;
+
+// Keeps only the bright parts of the scene, for the bloom chain
+void main()
+{
+    vec3 source = texture(texture0, fragTexCoord).rgb;
+    float brightness = dot(source, vec3(0.299, 0.587, 0.114)); // Luminance
+    float amount = smoothstep(threshold - knee, threshold + knee, brightness);
+    finalColor = vec4(source * amount, 1.0);
+}
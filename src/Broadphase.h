@@ -0,0 +1,369 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include <vector>
+#include <cmath>
+#include <cfloat>
+
+// Dynamic AABB tree (the Box2D b2DynamicTree layout). Leaves store a "fat" box
+// padded by margin, so small moves don't touch the tree at all. Queries only
+// read the tree and may run from several threads at once.
+class AABBTree {
+public:
+    static const int nullNode = -1;
+    float margin = 0.1f;
+
+    int CreateProxy(BoundingBox box, int userData) {
+        int leaf = AllocateNode();
+        nodes[leaf].box = Fatten(box);
+        nodes[leaf].userData = userData;
+        nodes[leaf].height = 0;
+        InsertLeaf(leaf);
+        proxyCount++;
+        return leaf;
+    }
+
+    void DestroyProxy(int proxy) {
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        proxyCount--;
+    }
+
+    // Returns true when the proxy had to be re-inserted
+    bool MoveProxy(int proxy, BoundingBox box) {
+        if (Contains(nodes[proxy].box, box)) return false;
+        RemoveLeaf(proxy);
+        nodes[proxy].box = Fatten(box);
+        InsertLeaf(proxy);
+        return true;
+    }
+
+    void Clear() {
+        nodes.clear();
+        root = nullNode;
+        freeList = nullNode;
+        proxyCount = 0;
+    }
+
+    int GetUserData(int proxy) const { return nodes[proxy].userData; }
+    BoundingBox GetFatBox(int proxy) const { return nodes[proxy].box; }
+    int GetProxyCount() const { return proxyCount; }
+    int GetHeight() const { return root == nullNode ? 0 : nodes[root].height; }
+
+    // callback(userData) returns false to stop the query early
+    template <typename F>
+    void Query(BoundingBox box, F&& callback) const {
+        if (root == nullNode) return;
+        TraversalStack<int> stack;
+        stack.Push(root);
+        while (!stack.IsEmpty()) {
+            const Node& node = nodes[stack.Pop()];
+            if (!Overlaps(node.box, box)) continue;
+            if (node.IsLeaf()) {
+                if (!callback(node.userData)) return;
+            }
+            else {
+                stack.Push(node.child1);
+                stack.Push(node.child2);
+            }
+        }
+    }
+
+    // classify(box, parentInside) says whether a box is outside a volume
+    // (-1), crosses it (0) or is wholly inside (1); parentInside tells it an
+    // enclosing box already was, so it can skip testing the volume again.
+    // callback(userData, inside) gets every leaf not outside, and returns
+    // false to stop early.
+    template <typename C, typename F>
+    void QueryVolume(C&& classify, F&& callback) const {
+        if (root == nullNode) return;
+        struct Entry {
+            int node;
+            bool parentInside;
+        };
+        TraversalStack<Entry> stack;
+        stack.Push({ root, false });
+        while (!stack.IsEmpty()) {
+            Entry entry = stack.Pop();
+            const Node& node = nodes[entry.node];
+            int side = classify(node.box, entry.parentInside);
+            if (side < 0) continue;
+            bool inside = side > 0;
+            if (node.IsLeaf()) {
+                if (!callback(node.userData, inside)) return;
+            }
+            else {
+                stack.Push({ node.child1, inside });
+                stack.Push({ node.child2, inside });
+            }
+        }
+    }
+
+    // callback(userData) returns the new max distance: keep maxDistance to continue,
+    // return a hit distance to clip the ray, or 0 to stop
+    template <typename F>
+    void RayQuery(Ray ray, float maxDistance, F&& callback) const {
+        if (root == nullNode) return;
+        Vector3 invDir = {
+            1.0f / ray.direction.x,
+            1.0f / ray.direction.y,
+            1.0f / ray.direction.z
+        };
+        TraversalStack<int> stack;
+        stack.Push(root);
+        while (!stack.IsEmpty()) {
+            const Node& node = nodes[stack.Pop()];
+            if (!RayHitsBox(ray.position, ray.direction, invDir, node.box, maxDistance)) continue;
+            if (node.IsLeaf()) {
+                maxDistance = callback(node.userData);
+                if (maxDistance <= 0.0f) return;
+            }
+            else {
+                stack.Push(node.child1);
+                stack.Push(node.child2);
+            }
+        }
+    }
+
+    static bool Overlaps(const BoundingBox& a, const BoundingBox& b) {
+        return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+            a.min.y <= b.max.y && a.max.y >= b.min.y &&
+            a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+
+private:
+    // The tree is kept balanced, so its height stays far below this
+    static const int stackSize = 256;
+
+    // Query stack on the caller's stack, spilling to the heap only if a tree
+    // ever gets deeper than stackSize (a bug, or boxes inserted in a
+    // pathological order), instead of writing past the end
+    template <typename T>
+    struct TraversalStack {
+        T fixed[stackSize];
+        std::vector<T> spill;
+        int count = 0;
+
+        void Push(const T& value) {
+            if (count < stackSize) fixed[count] = value;
+            else spill.push_back(value);
+            count++;
+        }
+
+        T Pop() {
+            count--;
+            if (count < stackSize) return fixed[count];
+            T value = spill.back();
+            spill.pop_back();
+            return value;
+        }
+
+        bool IsEmpty() const { return count == 0; }
+    };
+
+    struct Node {
+        BoundingBox box;
+        int parent = nullNode; // doubles as the free list link
+        int child1 = nullNode;
+        int child2 = nullNode;
+        int height = -1;       // 0 for leaves, -1 for free nodes
+        int userData = -1;
+        bool IsLeaf() const { return child1 == nullNode; }
+    };
+
+    std::vector<Node> nodes;
+    int root = nullNode;
+    int freeList = nullNode;
+    int proxyCount = 0;
+
+    BoundingBox Fatten(BoundingBox box) const {
+        Vector3 pad = { margin, margin, margin };
+        return { Vector3Subtract(box.min, pad), Vector3Add(box.max, pad) };
+    }
+
+    static bool Contains(const BoundingBox& outer, const BoundingBox& inner) {
+        return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+            outer.max.x >= inner.max.x && outer.max.y >= inner.max.y && outer.max.z >= inner.max.z;
+    }
+
+    static BoundingBox Union(const BoundingBox& a, const BoundingBox& b) {
+        return { Vector3Min(a.min, b.min), Vector3Max(a.max, b.max) };
+    }
+
+    static float SurfaceArea(const BoundingBox& box) {
+        Vector3 d = Vector3Subtract(box.max, box.min);
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    // Slab test. An axis the ray doesn't move along only needs the origin
+    // inside that slab: its invDir is inf, and inf * 0 for an origin on the
+    // face would be NaN and drop the box.
+    static bool RayHitsBox(Vector3 origin, Vector3 direction, Vector3 invDir, const BoundingBox& box, float maxDistance) {
+        const float* o = &origin.x;
+        const float* d = &direction.x;
+        const float* inv = &invDir.x;
+        const float* lo = &box.min.x;
+        const float* hi = &box.max.x;
+        float tmin = 0.0f, tmax = maxDistance;
+        for (int axis = 0; axis < 3; axis++) {
+            if (d[axis] == 0.0f) {
+                if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+                continue;
+            }
+            float t1 = (lo[axis] - o[axis]) * inv[axis], t2 = (hi[axis] - o[axis]) * inv[axis];
+            tmin = fmaxf(tmin, fminf(t1, t2));
+            tmax = fminf(tmax, fmaxf(t1, t2));
+        }
+        return tmin <= tmax;
+    }
+
+    int AllocateNode() {
+        if (freeList == nullNode) {
+            nodes.push_back(Node());
+            return (int)nodes.size() - 1;
+        }
+        int id = freeList;
+        freeList = nodes[id].parent;
+        nodes[id] = Node();
+        return id;
+    }
+
+    void FreeNode(int id) {
+        nodes[id].parent = freeList;
+        nodes[id].height = -1;
+        freeList = id;
+    }
+
+    void InsertLeaf(int leaf) {
+        if (root == nullNode) {
+            root = leaf;
+            nodes[root].parent = nullNode;
+            return;
+        }
+
+        // Walk down picking the child that grows the least in surface area
+        BoundingBox leafBox = nodes[leaf].box;
+        int index = root;
+        while (!nodes[index].IsLeaf()) {
+            int child1 = nodes[index].child1;
+            int child2 = nodes[index].child2;
+            float area = SurfaceArea(nodes[index].box);
+            float combinedArea = SurfaceArea(Union(nodes[index].box, leafBox));
+            float cost = 2.0f * combinedArea;
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            float cost1 = SurfaceArea(Union(leafBox, nodes[child1].box)) + inheritanceCost;
+            if (!nodes[child1].IsLeaf()) cost1 -= SurfaceArea(nodes[child1].box);
+            float cost2 = SurfaceArea(Union(leafBox, nodes[child2].box)) + inheritanceCost;
+            if (!nodes[child2].IsLeaf()) cost2 -= SurfaceArea(nodes[child2].box);
+
+            if (cost < cost1 && cost < cost2) break;
+            index = cost1 < cost2 ? child1 : child2;
+        }
+
+        int sibling = index;
+        int oldParent = nodes[sibling].parent;
+        int newParent = AllocateNode();
+        nodes[newParent].parent = oldParent;
+        nodes[newParent].box = Union(leafBox, nodes[sibling].box);
+        nodes[newParent].height = nodes[sibling].height + 1;
+        nodes[newParent].child1 = sibling;
+        nodes[newParent].child2 = leaf;
+        nodes[sibling].parent = newParent;
+        nodes[leaf].parent = newParent;
+
+        if (oldParent != nullNode) {
+            if (nodes[oldParent].child1 == sibling) nodes[oldParent].child1 = newParent;
+            else nodes[oldParent].child2 = newParent;
+        }
+        else {
+            root = newParent;
+        }
+
+        Refit(nodes[leaf].parent);
+    }
+
+    void RemoveLeaf(int leaf) {
+        if (leaf == root) {
+            root = nullNode;
+            return;
+        }
+
+        int parent = nodes[leaf].parent;
+        int grandParent = nodes[parent].parent;
+        int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+        if (grandParent != nullNode) {
+            if (nodes[grandParent].child1 == parent) nodes[grandParent].child1 = sibling;
+            else nodes[grandParent].child2 = sibling;
+            nodes[sibling].parent = grandParent;
+            FreeNode(parent);
+            Refit(grandParent);
+        }
+        else {
+            root = sibling;
+            nodes[sibling].parent = nullNode;
+            FreeNode(parent);
+        }
+    }
+
+    // Rebalances and recomputes boxes from index up to the root
+    void Refit(int index) {
+        while (index != nullNode) {
+            index = Balance(index);
+            int child1 = nodes[index].child1;
+            int child2 = nodes[index].child2;
+            nodes[index].height = 1 + (nodes[child1].height > nodes[child2].height ? nodes[child1].height : nodes[child2].height);
+            nodes[index].box = Union(nodes[child1].box, nodes[child2].box);
+            index = nodes[index].parent;
+        }
+    }
+
+    // Single tree rotation when one side is more than one level taller.
+    // Returns the index now sitting where a was.
+    int Balance(int a) {
+        Node& A = nodes[a];
+        if (A.IsLeaf() || A.height < 2) return a;
+
+        int b = A.child1;
+        int c = A.child2;
+        int balance = nodes[c].height - nodes[b].height;
+        if (balance > 1) return Rotate(a, c, b);
+        if (balance < -1) return Rotate(a, b, c);
+        return a;
+    }
+
+    // Promotes the tall child up over a; other is a's remaining child
+    int Rotate(int a, int tall, int other) {
+        int f = nodes[tall].child1;
+        int g = nodes[tall].child2;
+
+        nodes[tall].child1 = a;
+        nodes[tall].parent = nodes[a].parent;
+        nodes[a].parent = tall;
+
+        int tallParent = nodes[tall].parent;
+        if (tallParent != nullNode) {
+            if (nodes[tallParent].child1 == a) nodes[tallParent].child1 = tall;
+            else nodes[tallParent].child2 = tall;
+        }
+        else {
+            root = tall;
+        }
+
+        // Keep the taller grandchild under tall and hand the other one to a
+        int keep = f, give = g;
+        if (nodes[f].height < nodes[g].height) { keep = g; give = f; }
+
+        nodes[tall].child2 = keep;
+        if (nodes[a].child1 == tall) nodes[a].child1 = give;
+        else nodes[a].child2 = give;
+        nodes[give].parent = a;
+
+        nodes[a].box = Union(nodes[other].box, nodes[give].box);
+        nodes[a].height = 1 + (nodes[other].height > nodes[give].height ? nodes[other].height : nodes[give].height);
+        nodes[tall].box = Union(nodes[a].box, nodes[keep].box);
+        nodes[tall].height = 1 + (nodes[a].height > nodes[keep].height ? nodes[a].height : nodes[keep].height);
+        return tall;
+    }
+};
@@ -2,18 +2,20 @@
 #include "raylib.h"
 #include "Misc.h"
 #include "Classes.h"
+#include "Input.h"
 extern float camdistance;  // Distance between camera and target
 extern float yaw;  // Rotation around Y-axis (left/right)
 extern float pitch;  // Rotation around X-axis (up/down)
 extern float offsetY;
 
-void MainCamControls(Camera& camera, float dt, Player& player, int mode = 0) {
+void MainCamControls(Camera& camera, const InputFrame& input, const PlayerPose& player, int mode = 0) {
+    float dt = input.frameTime;
     float camAngle = 0.0f;
     float targetAngle = 0.0f;
     if (mode == 0) {
 
-        if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) {
-            Vector2 mouseDelta = GetMouseDelta();
+        if (input.IsDown(INPUT_POINTER)) {
+            Vector2 mouseDelta = input.mouseDelta;
             yaw += mouseDelta.x * 0.1f;  // Rotate around Y-axis (yaw)
             pitch -= mouseDelta.y * 0.1f;  // Rotate around X-axis (pitch)
 
@@ -27,7 +29,7 @@ void MainCamControls(Camera& camera, float dt, Player& player, int mode = 0) {
             camera.position.z = camera.target.z - camdistance * cos(DEG2RAD * pitch) * cos(DEG2RAD * yaw);
         }
         // Zoom in and out with mouse scroll
-        float scroll = GetMouseWheelMove();
+        float scroll = input.wheel;
         camdistance -= scroll * 2.0f;  // Adjust the zoom speed (you can change the multiplier)
 
         // Constrain the distance to avoid zooming too close or too far
@@ -35,7 +37,7 @@ void MainCamControls(Camera& camera, float dt, Player& player, int mode = 0) {
         if (camdistance > 100.0f) camdistance = 100.0f;
         Vector3 direction = Vector3Normalize(Vector3Subtract(camera.position, camera.target));
         camera.position = Vector3Add(camera.target, Vector3Scale(direction, camdistance));
-        if (IsKeyPressed(KEY_F)) {
+        if (input.IsPressed(INPUT_FULLSCREEN)) {
             ToggleFullscreen();
         }
         if (Vector3Length(Vector3Subtract(camera.position, camera.target)) < 10.) {
@@ -46,17 +48,9 @@ void MainCamControls(Camera& camera, float dt, Player& player, int mode = 0) {
     }
     if (mode == 1) {
         // --- Third-Person Camera Logic ---
-        float dt = GetFrameTime(); // Get frame time
-
-        // 1. Determine if the player is trying to move (check keys directly)
-        bool isPlayerMoving = false;
-        if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP) ||
-            IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN) ||
-            IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT) ||
-            IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT))
-        {
-            isPlayerMoving = true;
-        }
+
+        // 1. Determine if the player is trying to move
+        bool isPlayerMoving = input.IsMoving();
 
         // 2. Update Yaw and Pitch
         if (isPlayerMoving) {
@@ -73,13 +67,13 @@ void MainCamControls(Camera& camera, float dt, Player& player, int mode = 0) {
             yaw += angleDiff * 1.0f * dt; // Adjust lerp speed (8.0f) as needed
 
             // Keep pitch controlled by mouse
-            Vector2 mouseDelta = GetMouseDelta();
+            Vector2 mouseDelta = input.mouseDelta;
             pitch -= mouseDelta.y * 0.1f;
 
         }
         else {
             // --- Manual Orbit Camera Logic (when not moving) ---
-            Vector2 mouseDelta = GetMouseDelta();
+            Vector2 mouseDelta = input.mouseDelta;
             yaw -= mouseDelta.x * 0.1f;
             pitch += mouseDelta.y * 0.1f;
         }
@@ -103,7 +97,7 @@ void MainCamControls(Camera& camera, float dt, Player& player, int mode = 0) {
         camera.position = Vector3Lerp(camera.position, idealPosition, 15.0f * dt);
 
         // 6. Handle Zoom
-        float scroll = GetMouseWheelMove();
+        float scroll = input.wheel;
         camdistance -= scroll * 2.0f;
         if (camdistance < 2.0f) camdistance = 2.0f;
         if (camdistance > 20.0f) camdistance = 20.0f;
@@ -1,11 +1,25 @@
 #pragma once
 #include "raylib.h"
 #include "Misc.h"
+#include "RopeSolver.h"
+#include "Broadphase.h"
+#include "Terrain.h"
+#include "Resources.h"
+#include "Frustum.h"
+#include "Visibility.h"
+#include "Collision.h"
+#include "Animation.h"
+#include "Assets.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Log.h"
+#include "Input.h"
 #include "imgui.h"
 #include <vector>
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <cfloat>
 
 using namespace std;
 class Block {
@@ -14,97 +28,212 @@ public:
     Vector3 scale;
     Vector3 rotation;
     Color color = WHITE;
-    Mesh mesh;
-    Material mat = LoadMaterialDefault();
+    Mesh mesh = { 0 };                 // custom mesh; empty uses the shared unit cube
+    Vector3 meshScale = { 1, 1, 1 };   // size a custom mesh was generated at
     Matrix transform = MatrixIdentity();
+    BoundingBox renderBounds = { 0 };  // world box around the drawn mesh, rotation included
+    bool transformDirty = true;        // set when position/rotation/scale change
     std::string name = "Block";
     int layer = 1;
+    int proxyId = AABBTree::nullNode; // broadphase handle, owned by World
+    Terrain* terrain = nullptr;        // height field collision for the ground (layer 0)
+    OrientedBox orientedBox;           // see GetOrientedBox
 
     Block(Vector3 pos = { 0, 0, 0 }, Vector3 scl = { 1, 1, 1 }, Vector3 rot = { 0, 0, 0 },
         Color col = WHITE, std::string blockName = "Block", int lay = 1)
-        : position(pos), scale(scl), rotation(rot), color(col), name(blockName), layer(lay), lastScale(scl) {
-        mesh = GenMeshCube(scale.x, scale.y, scale.z);
+        : position(pos), scale(scl), rotation(rot), color(col), name(blockName), layer(lay) {
+        UpdateOrientedBox();
     }
 
-    void Draw() {
-        if (!Vector3Equals(scale, lastScale)) {
-            if (mesh.vertexCount > 0) UnloadMesh(mesh);
-            mesh = GenMeshCube(scale.x, scale.y, scale.z);
-            lastScale = scale;
-        }
+    // Doesn't load the shared cube, so batching works headlessly. The address is
+    // stable and the data is there once GetSharedResources() has run.
+    const Mesh& GetMesh() const {
+        return mesh.vertexCount > 0 ? mesh : SharedResources::Instance().unitCube;
+    }
 
-        mat.maps->color = color;
-        if (layer == 1) {
-			transform = CreateTransformMatrix(position, rotation);
-			DrawMesh(mesh, mat, transform);
-        }
+    // Axis-aligned box around the rotated cube, so it is the block itself when
+    // the block isn't rotated. Player collision sweeps the oriented box instead.
+    BoundingBox GetCollisionBox() const {
+        return orientedBox.GetBounds();
+    }
+
+    // The cube the block is drawn as, rotation included. Kept apart from the
+    // render transform so rope jobs can read it while the main thread draws.
+    const OrientedBox& GetOrientedBox() const {
+        return orientedBox;
+    }
+
+    // Call after position, rotation or scale change (World does)
+    void UpdateOrientedBox() {
+        orientedBox = MakeOrientedBox(position, rotation, scale);
+    }
+
+    // Puts the height field under the block: centered in x/z, rising from position.y
+    void PlaceTerrain() {
+        if (terrain == nullptr) return;
+        terrain->Place({ position.x - scale.x / 2, position.y, position.z - scale.z / 2 }, scale);
+    }
+
+    // Broadphase bounds, around the rotated box so rope contacts on tilted blocks
+    // are found. The ground heightmap spans [y, y + scale.y] instead of
+    // being centered, so layer 0 also has to cover that.
+    BoundingBox GetBounds() const {
+        if (terrain != nullptr) return terrain->GetBounds();
+        BoundingBox box = GetCollisionBox();
+        if (layer == 0) box.max.y = position.y + scale.y;
+        return box;
+    }
+
+    // Scale lives in the transform, so resizing a block never touches vertex data.
+    // Only recomputed after something marked the block dirty.
+    void UpdateTransform() {
+        if (!transformDirty) return;
+        Vector3 meshScaling = { scale.x / meshScale.x, scale.y / meshScale.y, scale.z / meshScale.z };
         if (layer == 0) {
-            transform = CreateTransformMatrix({ position.x - scale.x/2,position.y,position.z - scale.z/2 }, rotation);
-            DrawMesh(mesh, mat, transform);
+            transform = ComposeTransform({ position.x - scale.x/2,position.y,position.z - scale.z/2 }, rotation, meshScaling);
         }
-        
+        else {
+            transform = ComposeTransform(position, rotation, meshScaling);
+        }
+        renderBounds = mesh.vertexCount > 0 || terrain != nullptr ? GetBounds() : TransformBox({ { -0.5f, -0.5f, -0.5f }, { 0.5f, 0.5f, 0.5f } }, transform);
+        transformDirty = false;
     }
 
-private:
-    Vector3 lastScale;
+    // Valid after UpdateTransform
+    BoundingBox GetRenderBounds() const {
+        return renderBounds;
+    }
+
+    void Draw() {
+        Material& mat = GetSharedResources().defaultMaterial;
+        mat.maps->color = color;
+        Draw(mat);
+    }
+
+    // With material as it is (the outline mask)
+    void Draw(const Material& material) {
+        UpdateTransform();
+        DrawMesh(GetMesh(), material, transform);
+    }
 };
+// Per-instance playback of shared ModelAssets: clock, cross-fade, skin matrices
+// and the skinned vertices. Assets are owned by the AssetCache.
 class Animator {
 private:
-	std::vector<ModelAnimation*> modelAnims;
-	std::vector<int> animCounts;
+	std::vector<ModelAsset*> assets;
+	std::vector<Transform> blendedPose;
+	std::vector<Matrix> skinMatrices;
+	std::vector<std::vector<float>> skinnedVertices; // per mesh of skinnedAsset
+	std::vector<std::vector<float>> skinnedNormals;
+	ModelAsset* skinnedAsset = nullptr;
+	bool uploadPending = false;
 	int currentAnimIndex = 0;
-	int animFrame = 0;
-	float animTime = 0.0f;
+	int previousAnimIndex = -1; // clip being faded out, -1 when not fading
+	float animTime = 0.0f;      // in source frames
+	float previousAnimTime = 0.0f;
+	float fadeElapsed = 0.0f;
 	float animSpeed = 60.0f;
+	int lastSkinnedSlot = -1;
+	int framesUntilPose = 0;    // pose updates skipped for distant characters
+	JobCounter skinJob;
+
+	// Vertices per skinning job, so one large mesh still spreads over the workers
+	static const int skinBatchSize = 4096;
 
 public:
+	float crossFadeTime = 0.2f; // seconds
+	bool skinOnWorkers = true;
+
 	Animator() = default;
 
-	void LoadAnimations(const std::vector<const char*>& paths) {
-		for (const auto& path : paths) {
-			int count = 0;
-			auto anims = LoadModelAnimations(path, &count);
-			modelAnims.push_back(anims);
-			animCounts.push_back(count);
-			std::cout << "Animator loaded: " << path << " | Anim count: " << count << std::endl;
-		}
+	void SetAssets(const std::vector<ModelAsset*>& modelAssets) {
+		assets = modelAssets;
 	}
 
 	void Unload() {
-		for (int i = 0; i < modelAnims.size(); ++i) {
-			if (modelAnims[i]) UnloadModelAnimations(modelAnims[i], animCounts[i]);
-		}
-		std::cout << "Animator resources unloaded.\n";
+		JobSystem::Get().Wait(skinJob);
+		assets.clear();
+		skinnedAsset = nullptr;
 	}
 
-	void UpdateAnimation(Model& model, int index) {
-		static int lastFrame = -1;
+	// Advances time and, when visible, starts skinning the new pose. Skinning
+	// runs on the job system; FinishSkinning uploads the result before drawing.
+	// Off-screen characters keep their clock running but skip skinning, and
+	// distant ones only take a new pose every interval frames.
+	void UpdateAnimation(int index, float dt, bool visible = true, int interval = 1) {
+		if (!HasClip(index)) return;
+		JobSystem::Get().Wait(skinJob);
 
 		if (index != currentAnimIndex) {
+			previousAnimIndex = HasClip(currentAnimIndex) ? currentAnimIndex : -1;
+			previousAnimTime = animTime;
+			fadeElapsed = 0.0f;
 			currentAnimIndex = index;
-			animFrame = 0;
 			animTime = 0.0f;
-			lastFrame = -1; // force update on switch
+			framesUntilPose = 0; // show the new clip straight away
 		}
-
-		if (modelAnims[index] && animCounts[index] > 0) {
-			animTime += GetFrameTime();
-			float frameDuration = 1.0f / animSpeed;
-
-			int totalFrames = modelAnims[index][0].frameCount;
-			int nextFrame = animFrame;
-
-			if (animTime >= frameDuration) {
-				animTime -= frameDuration;
-				nextFrame = (totalFrames > 0) ? (animFrame + 1) % totalFrames : animFrame;
+		animTime = WrapTime(index, animTime + dt * animSpeed);
+		if (previousAnimIndex >= 0) {
+			previousAnimTime = WrapTime(previousAnimIndex, previousAnimTime + dt * animSpeed);
+			fadeElapsed += dt;
+			if (fadeElapsed >= crossFadeTime) previousAnimIndex = -1;
+		}
+		if (!visible) return;
+		if (framesUntilPose > 0) {
+			framesUntilPose--;
+			return;
+		}
+		framesUntilPose = interval - 1;
+
+		ModelAsset& asset = *assets[index];
+		const Model& model = asset.model;
+		PoseCache& cache = asset.poseCache;
+		if (cache.GetBoneCount() != model.boneCount) return;
+		int slot = cache.SampleIndex(animTime);
+		const Transform* pose = cache.Sample(slot);
+
+		bool fading = previousAnimIndex >= 0 && assets[previousAnimIndex]->poseCache.GetBoneCount() == model.boneCount;
+		if (fading) {
+			PoseCache& from = assets[previousAnimIndex]->poseCache;
+			const Transform* fromPose = from.Sample(from.SampleIndex(previousAnimTime));
+			float weight = Clamp(fadeElapsed / crossFadeTime, 0.0f, 1.0f);
+			blendedPose.resize(model.boneCount);
+			for (int bone = 0; bone < model.boneCount; bone++) {
+				blendedPose[bone] = BlendTransform(fromPose[bone], pose[bone], weight);
 			}
+			pose = blendedPose.data();
+			lastSkinnedSlot = -1;
+		}
+		else if (skinnedAsset == &asset && slot == lastSkinnedSlot) {
+			return; // same cached sample as last frame, the skinned vertices are current
+		}
+		else {
+			lastSkinnedSlot = slot;
+		}
 
-			if (nextFrame != lastFrame) {
-				animFrame = nextFrame;
-				lastFrame = animFrame;
-				UpdateModelAnimation(model, modelAnims[index][0], animFrame);
-			}
+		ComputeSkinMatrices(pose, asset.inverseBind, skinMatrices);
+		StartSkinning(asset);
+	}
+
+	// Waits for the skinning jobs and puts this instance's vertices in the GPU
+	// buffers. Instances sharing the asset re-upload when another one drew last.
+	// Main thread only, right before drawing.
+	void FinishSkinning(ModelAsset* drawn) {
+		PROFILE_ZONE("Skin upload");
+		JobSystem::Get().Wait(skinJob);
+		if (!skinnedAsset || skinnedAsset != drawn) return;
+		if (!uploadPending && skinnedAsset->uploadedBy == this) return;
+
+		Model& model = skinnedAsset->model;
+		for (int m = 0; m < model.meshCount; m++) {
+			Mesh& mesh = model.meshes[m];
+			if (!IsSkinned(mesh)) continue;
+			int size = mesh.vertexCount * 3 * sizeof(float);
+			UpdateMeshBuffer(mesh, 0, skinnedVertices[m].data(), size, 0);
+			if (mesh.normals) UpdateMeshBuffer(mesh, 2, skinnedNormals[m].data(), size, 0);
 		}
+		skinnedAsset->uploadedBy = this;
+		uploadPending = false;
 	}
 
 	void SetAnimationSpeed(float fps) {
@@ -112,7 +241,45 @@ public:
 	}
 
 	int GetCurrentAnimationIndex() const { return currentAnimIndex; }
-	int GetAnimationCount() const { return animCounts[currentAnimIndex]; }
+	int GetAnimationCount() const { return HasClip(currentAnimIndex) ? assets[currentAnimIndex]->animationCount : 0; }
+	bool IsCrossFading() const { return previousAnimIndex >= 0; }
+
+private:
+	bool HasClip(int index) const {
+		return index >= 0 && index < (int)assets.size() && assets[index]->HasClip(); // false while streaming
+	}
+
+	float WrapTime(int index, float frame) const {
+		float length = (float)assets[index]->animations[0].frameCount;
+		return length > 0.0f ? fmodf(frame, length) : 0.0f;
+	}
+
+	void StartSkinning(ModelAsset& asset) {
+		const Model& model = asset.model;
+		skinnedVertices.resize(model.meshCount);
+		skinnedNormals.resize(model.meshCount);
+		const Matrix* skin = skinMatrices.data();
+		for (int m = 0; m < model.meshCount; m++) {
+			const Mesh& mesh = model.meshes[m];
+			if (!IsSkinned(mesh)) continue;
+			skinnedVertices[m].resize(mesh.vertexCount * 3);
+			skinnedNormals[m].resize(mesh.normals ? mesh.vertexCount * 3 : 0);
+			float* outVertices = skinnedVertices[m].data();
+			float* outNormals = mesh.normals ? skinnedNormals[m].data() : nullptr;
+			for (int first = 0; first < mesh.vertexCount; first += skinBatchSize) {
+				int last = std::min(first + skinBatchSize, mesh.vertexCount);
+				if (skinOnWorkers) {
+					JobSystem::Get().Run(skinJob, [mesh, skin, outVertices, outNormals, first, last] {
+						PROFILE_ZONE("Skinning");
+						SkinVertices(mesh, skin, outVertices, outNormals, first, last);
+					});
+				}
+				else SkinVertices(mesh, skin, outVertices, outNormals, first, last);
+			}
+		}
+		skinnedAsset = &asset;
+		uploadPending = true;
+	}
 };
 
 class PhysicsBody {
@@ -121,10 +288,10 @@ public:
     float gravity = 19.81f;
     Vector3 velocity = { 0,0 };
     BoxCollider collider;
-    void ApplyGravity(Vector3& position) {
-        velocity.y -= gravity * GetFrameTime();
+    void ApplyGravity(Vector3& position, float dt) {
+        velocity.y -= gravity * dt;
         velocity.y = Clamp(velocity.y, -gravity * 2, gravity * 2);
-        position.y += velocity.y * GetFrameTime();
+        position.y += velocity.y * dt;
     }
     virtual void OnCollision(PhysicsBody& other) {
     }
@@ -132,242 +299,515 @@ public:
 
 class Rope {
 public:
-    struct Point {
-        Vector3 position;
-        Vector3 oldPosition;
-        bool locked = false;
-        bool yLocked = false;
-        float yLockHeight = 0.0f;
-    };
-    std::vector<Point> points;
-    std::vector<std::pair<int, int>> constraints;
+    RopePoints points;
+    std::vector<unsigned char> contact; // touched a block or the ground in the last OnRopeCollision
     int numPoints = 10;
-    float segmentLength = 25.0f;
-    float gravity = 0.05f;
-    float currentTotalLength = 0.0f;
-    float maxTensionFactor = 1.5f;
-    bool IsTensionMaxed() {
-        currentTotalLength = 0.0f;
-        for (auto [a, b] : constraints) {
-            Vector3 delta = Vector3Subtract(points[b].position, points[a].position);
-            currentTotalLength += Vector3Length(delta);
-        }
-
-        float baseLength = segmentLength * (numPoints - 1);
-        return currentTotalLength > baseLength * maxTensionFactor;
+    int iterations = 20;        // most relaxation sweeps per step
+    float tolerance = 0.01f;    // stop sweeping once no segment is stretched by more than this fraction
+    float segmentLength = 25.0f; // finest spacing, the one Init starts with
+    float restLength = 0.0f;    // whole rope
+    float gravity = 720.0f; // units/s^2, same sag as the old 0.05 per frame at 120 fps
+    float minLength = 1.0f;     // Reel limits
+    float maxLength = 100.0f;
+    float massPerLength = 0.01f; // what a point of invMass 1 weighs is this times segmentLength
+    // Inverse mass of what the ends are tied to, relative to a rope point. 0
+    // pins the end to its anchor; otherwise the solver pulls the end too and
+    // the owner reads it back (see Player::FollowRope).
+    float startInvMass = 0.0f;
+    float endInvMass = 0.0f;
+    float stretch = 0.0f;       // anchor distance over restLength at the last Update, 1 when pulled straight
+    float radius = 0.05f;       // collision thickness
+    float friction = 0.4f;      // tangential motion lost per unit of penetration
+    bool useSimd = ROPE_SIMD;
+    // Straight free spans are merged into longer segments and bends or contacts
+    // are split back down to segmentLength, so taut ropes solve few points
+    bool adaptive = true;
+    int minPoints = 4;          // Adapt never merges below this
+    float splitBend = 0.990f;   // split segments next to a bend sharper than this cosine (~8 degrees)
+    float mergeBend = 0.9994f;  // merge points straighter than this (~2 degrees)
+    int lastIterations = 0;     // sweeps the last Update ran
+
+    Vector3 GetPoint(int i) const { return { points.x[i], points.y[i], points.z[i] }; }
+    Vector3 GetOldPoint(int i) const { return { points.oldX[i], points.oldY[i], points.oldZ[i] }; }
+    void SetPoint(int i, Vector3 pos) { points.x[i] = pos.x; points.y[i] = pos.y; points.z[i] = pos.z; }
+    void SetOldPoint(int i, Vector3 pos) { points.oldX[i] = pos.x; points.oldY[i] = pos.y; points.oldZ[i] = pos.z; }
+    bool IsLocked(int i) const { return points.invMass[i] == 0.0f; }
+
+    float GetPointMass() const { return massPerLength * segmentLength; }
+
+    // Pays out (amount > 0) or hauls in (amount < 0) that much rope, within
+    // minLength and maxLength. Only the limit it moves towards applies, so a
+    // rope attached longer than maxLength can still be hauled in but never
+    // snaps shorter when paid out. Every segment scales, so the shape is kept.
+    void Reel(float amount) {
+        if (amount == 0.0f || restLength <= 0.0f) return;
+        float length = amount > 0.0f ? fminf(restLength + amount, fmaxf(maxLength, restLength))
+            : fmaxf(restLength + amount, fminf(minLength, restLength));
+        float scale = length / restLength;
+        for (int i = 0; i < numPoints - 1; i++) points.rest[i] *= scale;
+        segmentLength *= scale;
+        restLength = length;
     }
 
-    Vector3 GetRopeDirection() {
-        return Vector3Normalize(Vector3Subtract(points[0].position, points[numPoints - 1].position));
-    }
     void Init(int count, Vector3 start, Vector3 end) {
-        points.clear();
-        constraints.clear();
         numPoints = count;
+        points.Resize(numPoints);
+        contact.assign(numPoints, 0);
 
         Vector3 delta = Vector3Subtract(end, start);
         for (int i = 0; i < numPoints; i++) {
             float t = (float)i / (numPoints - 1);
             Vector3 pos = Vector3Add(start, Vector3Scale(delta, t));
-            points.push_back({ pos, pos });
+            SetPoint(i, pos);
+            SetOldPoint(i, pos);
         }
 
-        points[0].locked = true; // Anchor to player
-        points[numPoints - 1].locked = true; // Anchor to block
+        points.invMass[0] = startInvMass;
+        points.invMass[numPoints - 1] = endInvMass;
+        points.UpdateWeights();
 
-        for (int i = 0; i < numPoints - 1; i++) {
-            constraints.push_back({ i, i + 1 });
+        restLength = Vector3Length(Vector3Subtract(start, end));
+        segmentLength = restLength / (numPoints - 1);
+        points.rest.assign(numPoints, segmentLength);
+    }
+    // Capsule contacts against blocks and the ground, after Update. Each point is
+    // swept from its previous position so fast points can't tunnel through thin
+    // blocks, then each segment is pushed off box edges and corners it cuts
+    // through. Contacts move along the surface normal and lose tangential motion
+    // to friction. Only reads blocks and broadphase, so ropes can run in parallel.
+    void OnRopeCollision(const vector<Block>& blocks, const AABBTree& broadphase) {
+        Vector3 pad = { radius, radius, radius };
+        for (int i = 0; i < numPoints; i++) {
+            contact[i] = 0;
+            if (i == 0 || i == numPoints - 1) continue; // the ends go where they are tied
+            Vector3 old = GetOldPoint(i);
+            Vector3 position = GetPoint(i);
+            BoundingBox sweptBox = { Vector3Subtract(Vector3Min(old, position), pad), Vector3Add(Vector3Max(old, position), pad) };
+
+            broadphase.Query(sweptBox, [&](int blockIndex) {
+                const Block& block = blocks[blockIndex];
+                if (block.terrain != nullptr) {
+                    // A height field can't be tunneled through from above
+                    if (!block.terrain->Contains(position.x, position.z)) return true;
+                    float depth = block.terrain->GetHeight(position.x, position.z) + radius - position.y;
+                    if (depth > 0.0f) ResolveContact(i, position, old, { 0, 1, 0 }, depth);
+                    return true;
+                }
+                BoxContact hit = SweptSphereBoxContact(block.GetOrientedBox(), old, position, radius);
+                if (hit.hit) ResolveContact(i, position, old, hit.normal, hit.depth);
+                return true;
+            });
+            SetPoint(i, position);
         }
 
-        segmentLength = Vector3Length(Vector3Subtract(start, end)) / (numPoints - 1);
+        for (int i = 0; i < numPoints - 1; i++) {
+            if (i == 0 || i + 1 == numPoints - 1) continue; // segments at an end are meant to touch what it's tied to
+            float invA = points.invMass[i], invB = points.invMass[i + 1];
+            Vector3 a = GetPoint(i), b = GetPoint(i + 1);
+            BoundingBox segmentBox = { Vector3Subtract(Vector3Min(a, b), pad), Vector3Add(Vector3Max(a, b), pad) };
+            broadphase.Query(segmentBox, [&](int blockIndex) {
+                const Block& block = blocks[blockIndex];
+                if (block.terrain != nullptr) return true; // points are enough on the ground
+                const OrientedBox& box = block.GetOrientedBox();
+                float t = SegmentThroughBox(box, a, b, radius);
+                if (t < 0.0f) return true;
+                // Judge the side from where that spot was last step, like the points
+                Vector3 oldSpot = Vector3Lerp(GetOldPoint(i), GetOldPoint(i + 1), t);
+                BoxContact hit = SweptSphereBoxContact(box, oldSpot, Vector3Lerp(a, b, t), radius);
+                if (!hit.hit) return true;
+                // Split the push between the two ends by where along the segment it hits
+                float wA = (1.0f - t) * invA, wB = t * invB;
+                float denominator = (1.0f - t) * wA + t * wB;
+                if (denominator <= 1e-6f) return true;
+                float lambda = hit.depth / denominator;
+                a = Vector3Add(a, Vector3Scale(hit.normal, lambda * wA));
+                b = Vector3Add(b, Vector3Scale(hit.normal, lambda * wB));
+                contact[i] = contact[i + 1] = 1;
+                return true;
+            });
+            SetPoint(i, a);
+            SetPoint(i + 1, b);
+        }
     }
-    void OnRopeCollision(const vector<Block>& blocks) {
-        for (int i = 0; i < points.size(); i++) {
-            Point& point = points[i];
-            if (point.locked) continue;
-
-            BoundingBox pointBox = {
-                Vector3Subtract(point.position, Vector3{0.05f, 0.05f, 0.05f}),
-                Vector3Add(point.position, Vector3{0.05f, 0.05f, 0.05f})
-            };
-
-            for (const Block& block : blocks) {
-                BoundingBox blockBox = {
-                    Vector3Subtract(block.position, Vector3Scale(block.scale, 0.5f)),
-                    Vector3Add(block.position, Vector3Scale(block.scale, 0.5f))
-                };
 
-                if (CheckCollisionBoxes(pointBox, blockBox)) {
-                    float surfaceY = blockBox.max.y;
 
-                    // Snap rope point to the surface
-                    point.position.y = surfaceY;
-                    point.oldPosition.y = surfaceY;
-                    point.yLocked = true;
-                    point.yLockHeight = surfaceY;
-
-                    break;
-                }
-                else {
-                    // If no collision, unlock the y
-                    point.yLocked = false;
-                }
-            }
+    void Update(Vector3 playerPos, Vector3 blockPos, float dt) {
+        if (adaptive) Adapt();
+        if (points.invMass[0] != startInvMass || points.invMass[numPoints - 1] != endInvMass) {
+            points.invMass[0] = startInvMass;
+            points.invMass[numPoints - 1] = endInvMass;
+            points.UpdateWeights();
         }
 
-        // Optional: force neighbors into same Y if they are close and both yLocked
-        for (int i = 1; i < points.size() - 1; i++) {
-            if (points[i].yLocked && points[i - 1].yLocked) {
-                float avgY = (points[i].yLockHeight + points[i - 1].yLockHeight) * 0.5f;
-                points[i].position.y = avgY;
-                points[i - 1].position.y = avgY;
-            }
-        }
+        RopeIntegrate(points, gravity * dt * dt, useSimd);
+        // The ends start every step where their anchors are, after integration
+        // so a weighted end isn't carried on by its own momentum. They keep their
+        // previous step in oldPosition too, so Tessellate can interpolate them.
+        SetOldPoint(0, GetPoint(0));
+        SetPoint(0, playerPos);
+        SetOldPoint(numPoints - 1, GetPoint(numPoints - 1));
+        SetPoint(numPoints - 1, blockPos);
+
+        // Pulled tighter than its length the rope can only lie straight; solving
+        // for that instead of the unreachable rest length lets it converge
+        stretch = restLength > 0.0f ? Vector3Distance(playerPos, blockPos) / restLength : 1.0f;
+        lastIterations = RopeSolve(points, iterations, tolerance, useSimd, fmaxf(1.0f, stretch));
     }
 
+    // Cosine of the bend at point i; the ends count as straight
+    float GetBend(int i) const {
+        if (i <= 0 || i >= numPoints - 1) return 1.0f;
+        Vector3 a = Vector3Subtract(GetPoint(i), GetPoint(i - 1));
+        Vector3 b = Vector3Subtract(GetPoint(i + 1), GetPoint(i));
+        float lengths = Vector3Length(a) * Vector3Length(b);
+        return lengths > 1e-12f ? Vector3DotProduct(a, b) / lengths : 1.0f;
+    }
 
-    void Update(Vector3 playerPos, Vector3 blockPos) {
-        points[0].position = playerPos;
-        points[numPoints - 1].position = blockPos;
-
-        for (auto& p : points) {
-            if (!p.locked) {
-                Vector3 velocity = Vector3Subtract(p.position, p.oldPosition);
-                p.oldPosition = p.position;
-                p.position = Vector3Add(p.position, velocity);
-                p.position.y -= gravity;
-            }
+    // One merge pass and one split pass, using the contacts from the last collision
+    void Adapt() {
+        float maxSegment = restLength / (minPoints - 1);
+        bool changed = false;
+        for (int i = 1; i < numPoints - 1 && numPoints > minPoints; i++) {
+            if (contact[i - 1] || contact[i] || contact[i + 1]) continue;
+            if (points.rest[i - 1] + points.rest[i] > maxSegment * 1.001f) continue;
+            if (GetBend(i) < mergeBend) continue;
+            points.Merge(i);
+            contact.erase(contact.begin() + i);
+            numPoints--;
+            changed = true; // i now names the next point, leave it for the next pass
         }
-
-        for (int i = 0; i < 20; i++) {
-            for (auto [a, b] : constraints) {
-                Point& p1 = points[a];
-                Point& p2 = points[b];
-                Vector3 delta = Vector3Subtract(p2.position, p1.position);
-                float dist = Vector3Length(delta);
-                float diff = (dist - segmentLength) / dist;
-                Vector3 offset = Vector3Scale(delta, 0.5f * diff);
-
-                if (!p1.locked) p1.position = Vector3Add(p1.position, offset);
-                if (!p2.locked) p2.position = Vector3Subtract(p2.position, offset);
-            }
+        for (int i = 0; i < numPoints - 1; i++) {
+            if (points.rest[i] < segmentLength * 1.999f) continue;
+            bool touching = contact[i] || contact[i + 1];
+            if (!touching && GetBend(i) >= splitBend && GetBend(i + 1) >= splitBend) continue;
+            points.Subdivide(i);
+            contact.insert(contact.begin() + i + 1, 0);
+            numPoints++;
+            changed = true;
+            i++; // skip the new half
+        }
+        if (!changed) return;
+        // Each point carries the mass of the rope around it, so merged spans don't go light
+        for (int i = 1; i < numPoints - 1; i++) {
+            if (points.invMass[i] == 0.0f) continue;
+            points.invMass[i] = 2.0f * segmentLength / (points.rest[i - 1] + points.rest[i]);
         }
+        points.UpdateWeights();
     }
 
-    void DrawRope() {
-        int segmentsPerPair = 6; // the more, the smoother
-
-        for (int i = 1; i < points.size() - 2; i++) {
+    // Catmull-Rom polyline through every point, blended between the last two
+    // simulation steps by alpha (see FixedTimestep). The ends are extended by
+    // mirrored points so the curve reaches both anchors. Each span is a cubic
+    // stepped by forward differences: three adds per axis per vertex.
+    void Tessellate(float alpha, std::vector<Vector3>& out, int segmentsPerPair = 6) {
+        out.clear();
+        if (numPoints < 2) return;
+        drawPoints.resize(numPoints + 2);
+        for (int i = 0; i < numPoints; i++) {
+            drawPoints[i + 1] = Vector3Lerp(GetOldPoint(i), GetPoint(i), alpha);
+        }
+        drawPoints[0] = Vector3Subtract(Vector3Scale(drawPoints[1], 2.0f), drawPoints[2]);
+        drawPoints[numPoints + 1] = Vector3Subtract(Vector3Scale(drawPoints[numPoints], 2.0f), drawPoints[numPoints - 1]);
+
+        float h = 1.0f / segmentsPerPair;
+        float h2 = h * h, h3 = h2 * h;
+        out.reserve((numPoints - 1) * segmentsPerPair + 1);
+        for (int i = 1; i < numPoints; i++) {
+            Vector3 p0 = drawPoints[i - 1], p1 = drawPoints[i], p2 = drawPoints[i + 1], p3 = drawPoints[i + 2];
+            // p(t) = p1 + b t + c t^2 + d t^3, same curve as CatmullRom in Misc.h
+            Vector3 b = Vector3Scale(Vector3Subtract(p2, p0), 0.5f);
+            Vector3 c = { p0.x - 2.5f * p1.x + 2.0f * p2.x - 0.5f * p3.x,
+                          p0.y - 2.5f * p1.y + 2.0f * p2.y - 0.5f * p3.y,
+                          p0.z - 2.5f * p1.z + 2.0f * p2.z - 0.5f * p3.z };
+            Vector3 d = { 0.5f * (-p0.x + 3.0f * p1.x - 3.0f * p2.x + p3.x),
+                          0.5f * (-p0.y + 3.0f * p1.y - 3.0f * p2.y + p3.y),
+                          0.5f * (-p0.z + 3.0f * p1.z - 3.0f * p2.z + p3.z) };
+            Vector3 f = p1;
+            Vector3 d1 = Vector3Add(Vector3Add(Vector3Scale(b, h), Vector3Scale(c, h2)), Vector3Scale(d, h3));
+            Vector3 d2 = Vector3Add(Vector3Scale(c, 2.0f * h2), Vector3Scale(d, 6.0f * h3));
+            Vector3 d3 = Vector3Scale(d, 6.0f * h3);
             for (int j = 0; j < segmentsPerPair; j++) {
-                float t1 = (float)j / segmentsPerPair;
-                float t2 = (float)(j + 1) / segmentsPerPair;
-
-                Vector3 pA = CatmullRom(
-                    points[i - 1].position,
-                    points[i].position,
-                    points[i + 1].position,
-                    points[i + 2].position,
-                    t1
-                );
-
-                Vector3 pB = CatmullRom(
-                    points[i - 1].position,
-                    points[i].position,
-                    points[i + 1].position,
-                    points[i + 2].position,
-                    t2
-                );
-
-                DrawLine3D(pA, pB, RED);
+                out.push_back(f);
+                f = Vector3Add(f, d1);
+                d1 = Vector3Add(d1, d2);
+                d2 = Vector3Add(d2, d3);
             }
         }
+        out.push_back(drawPoints[numPoints]);
+    }
+
+    // Moves point i out along normal by depth, then takes friction off the
+    // tangential part of this step's motion: all of it while it is within
+    // friction * depth (sticking), that much of it otherwise (sliding)
+    void ResolveContact(int i, Vector3& position, Vector3 old, Vector3 normal, float depth) {
+        position = Vector3Add(position, Vector3Scale(normal, depth));
+        Vector3 moved = Vector3Subtract(position, old);
+        Vector3 tangent = Vector3Subtract(moved, Vector3Scale(normal, Vector3DotProduct(moved, normal)));
+        float slide = Vector3Length(tangent);
+        if (slide > 1e-9f) position = Vector3Subtract(position, Vector3Scale(tangent, fminf(1.0f, friction * depth / slide)));
+        contact[i] = 1;
     }
 
+private:
+    std::vector<Vector3> drawPoints; // scratch for Tessellate
+};
+// What drawing needs of a player, copied out at the end of a simulated frame
+struct PlayerPose {
+    Vector3 position = { 0, 0, 0 }; // interpolated between steps
+    Vector3 rotation = { 0, 0, 0 };
+    int animIndex = 0;
+};
+
+// One frame of player intent, sampled on the render thread and consumed by fixed steps
+struct PlayerInput {
+    Vector3 moveDir = { 0, 0, 0 }; // local x/z, not normalized
+    bool jump = false;
+    float cameraYaw = 0.0f;       // radians, camera forward around Y
+    float reel = 0.0f;            // -1 hauls the grapple in, 1 pays it out
 };
+
 class Player : public PhysicsBody {
 private:
-    std::vector<Model> models;
+    std::vector<ModelAsset*> assets; // one per path, shared through the AssetCache
     Animator animator;
+    std::vector<Shader> ownShaders;  // scratch for DrawMask
     bool isGrounded = false;
-    float cachedGroundY = 0.0f;
-    Vector2 lastCheckXZ = { -9999.0f, -9999.0f };
-    BoundingBox playerBox;
+    Vector3 moveDelta = { 0, 0, 0 };    // walking this step, from PlayerController
+    // A block the move can reach. Rotated blocks keep their oriented box, which
+    // the sweeps test instead of the looser axis-aligned box around it.
+    struct Obstacle {
+        BoundingBox box;
+        int block;
+        const OrientedBox* shape = nullptr; // nullptr when box is the block itself
+
+        // box.max.y is a flat top the player can stand or step onto
+        bool HasFlatTop() const {
+            if (shape == nullptr) return true;
+            for (const Vector3& axis : shape->axis) if (fabsf(axis.y) > 0.9999f) return true;
+            return false;
+        }
+        float Sweep(const BoundingBox& a, Vector3 delta, Vector3* normal) const {
+            return shape ? SweepBoxBox(a, delta, *shape, normal) : SweepBoxBox(a, delta, box, normal);
+        }
+        BoxContact Contact(const BoundingBox& a) const {
+            return shape ? BoxBoxContact(a, *shape) : BoxBoxContact(a, box);
+        }
+    };
+    std::vector<Obstacle> nearby;       // what this step's move can reach, reused every step
+    Vector3 boundsCenter = { 0, 0, 0 }; // bind-pose sphere around the model, in world units
+    float boundsRadius = 0.0f;
 
 public:
     std::vector<const char*> modelPaths;
     Vector3 position;
+    Vector3 previousPosition;
+    Vector3 renderPosition;
     Vector3 rotation;
     Vector3 scale;
     Color tint;
     float moveSpeed;
     int animIndex;
-    Shader shader = LoadShader(0, 0);
-
-    Player(std::vector<const char*> paths, Vector3 pos, Vector3 scl)
+    // Collision box, feet at position. Fixed rather than taken from the model
+    // so a physics-only player (replays, benchmarks) collides the same way.
+    float halfWidth = 0.3f;
+    float height = 1.6f;
+    float stepHeight = 0.35f;          // ledges up to this high are walked onto
+    float snapDistance = 0.2f;         // stays on the ground over drops this small
+    float skin = 0.001f;               // gap kept to whatever it stops against
+    float reelSpeed = 4.0f;            // grapple length hauled in or paid out per second
+
+    // With a streamer the models load in the background and a placeholder is drawn until then.
+    // No paths gives a body with physics only (headless benchmarks).
+    Player(std::vector<const char*> paths, Vector3 pos, Vector3 scl, AssetStreamer* streamer = nullptr)
         : modelPaths(paths),
         position(pos),
+        previousPosition(pos),
+        renderPosition(pos),
         scale(scl),
         rotation({ 0, 0, 0 }),
         tint(WHITE),
         moveSpeed(4.0f),
         animIndex(0)
     {
-        if (paths.empty()) {
-            std::cerr << "ERROR: modelPaths is empty!" << std::endl;
-            return;
-        }
-
+        mass = 70.0f; // against the rope's massPerLength
         for (const auto& path : paths) {
-            models.push_back(LoadModel(path));
+            AssetCache& cache = AssetCache::Instance();
+            assets.push_back(streamer ? cache.AcquireModelAsync(path, *streamer) : cache.AcquireModel(path));
         }
-
-        animator.LoadAnimations(paths);
+        animator.SetAssets(assets);
     }
 
     ~Player() {
-        for (Model& m : models) UnloadModel(m);
         animator.Unload();
-        std::cout << "Player resources unloaded." << std::endl;
+        for (ModelAsset* asset : assets) AssetCache::Instance().Release(asset);
+        LOG("Player resources released.\n");
+    }
+
+    BoundingBox GetCollisionBox(Vector3 feet) const {
+        return { { feet.x - halfWidth, feet.y, feet.z - halfWidth }, { feet.x + halfWidth, feet.y + height, feet.z + halfWidth } };
     }
 
-	void Update(std::vector<Block>& blocks) {
+    bool IsGrounded() const { return isGrounded; }
+
+    // Grapple: keeps the player within length of anchor, like a rope that
+    // can go slack but not stretch. Set every step the rope is attached.
+    void SetTether(Vector3 anchor, float length) {
+        tethered = true;
+        tetherAnchor = anchor;
+        tetherLength = length;
+    }
+
+    void ClearTether() { tethered = false; }
+
+    // One fixed step of the character controller: gravity, momentum and this
+    // step's walking, swept against everything in one broadphase query. Walls
+    // slide, low ledges are stepped onto and small drops are snapped down.
+    // In the air the player keeps its horizontal speed, so with a tether it swings.
+    void Update(std::vector<Block>& blocks, const AABBTree& broadphase, float dt) {
+        previousPosition = position;
+        bool wasGrounded = isGrounded;
         isGrounded = false;
-		// Create a ray from above the player's feet
-        Ray groundRay = {
-            .position = { position.x, position.y + 2.0f, position.z },
-            .direction = {0,-1,0}
-		};
-
-		// Check collision against blocks
-		for (Block& block : blocks) {
-			OnCollision(block, groundRay);
-		}
+        velocity.y = Clamp(velocity.y - gravity * dt, -gravity * 2, gravity * 2);
+        Vector3 delta = Vector3Add(moveDelta, Vector3Scale(velocity, dt));
+        moveDelta = { 0, 0, 0 };
+        if (tethered) ApplyTether(delta);
+
+        // Everything the move, a step up or a snap down could touch
+        BoundingBox reach = GetCollisionBox(position);
+        reach.min = Vector3Add(Vector3Min(reach.min, Vector3Add(reach.min, delta)), { -skin, -snapDistance - skin, -skin });
+        reach.max = Vector3Add(Vector3Max(reach.max, Vector3Add(reach.max, delta)), { skin, stepHeight + skin, skin });
+        const Terrain* terrain = nullptr;
+        nearby.clear();
+        broadphase.Query(reach, [&](int blockIndex) {
+            const Block& block = blocks[blockIndex];
+            if (block.terrain != nullptr) terrain = block.terrain;
+            else {
+                bool rotated = block.rotation.x != 0.0f || block.rotation.y != 0.0f || block.rotation.z != 0.0f;
+                nearby.push_back({ block.GetBounds(), blockIndex, rotated && block.layer != 0 ? &block.GetOrientedBox() : nullptr });
+            }
+            return true;
+        });
+
+        int landedOn = -1;
+        Depenetrate(landedOn);
+        Move(delta, wasGrounded, landedOn);
+        if (!isGrounded && wasGrounded && velocity.y <= 0.0f) {
+            // Walked off something low: follow it down instead of falling
+            Vector3 normal;
+            if (Sweep({ 0, -snapDistance, 0 }, &normal) >= 0 && normal.y > 0.0f) {
+                position.y -= snapDistance * lastSweep - skin;
+                isGrounded = true;
+            }
+        }
+
+        if (terrain != nullptr && terrain->Contains(position.x, position.z)) {
+            float groundY = terrain->GetHeight(position.x, position.z);
+            bool snap = wasGrounded && !isGrounded && velocity.y <= 0.0f && position.y - groundY <= snapDistance;
+            if (position.y < groundY || snap) {
+                position.y = groundY;
+                isGrounded = true;
+            }
+        }
+        if (isGrounded) {
+            if (velocity.y < 0.0f) velocity.y = 0.0f;
+            velocity.x = velocity.z = 0.0f; // walking isn't momentum
+        }
+        if (isGrounded && !wasGrounded && landedOn >= 0) LOG("Player landed on block %s\n", blocks[landedOn].name.c_str());
+    }
 
-		// Only apply gravity if not grounded
-		if (!isGrounded) ApplyGravity(position);
+    PlayerPose GetPose() const {
+        PlayerPose pose;
+        pose.position = renderPosition;
+        pose.rotation = rotation;
+        pose.animIndex = animIndex;
+        return pose;
+    }
 
-		// Animate
-		animator.UpdateAnimation(models[animIndex], animIndex);
-	}
+    // Animation is visual only, so it runs once per rendered frame rather than per step.
+    // lod comes from Visibility::TestCharacter on GetRenderBounds: skinning is
+    // skipped while the player is culled and runs less often far away. Animate
+    // and Draw only touch the animator, so they can run while the next frame simulates.
+    void Animate(float dt, const CharacterLod& lod, const PlayerPose& pose) {
+        if (assets.empty() || !assets[pose.animIndex]->ready) return;
+        animator.UpdateAnimation(pose.animIndex, dt, lod.visible, lod.animationInterval);
+    }
 
+    // World box the player is drawn inside: the padded bind-pose sphere once
+    // the model is in, the placeholder capsule until then
+    BoundingBox GetRenderBounds(const PlayerPose& pose) {
+        if (assets.empty() || !assets[0]->ready) {
+            return { { pose.position.x - halfWidth, pose.position.y - halfWidth, pose.position.z - halfWidth },
+                { pose.position.x + halfWidth, pose.position.y + height + halfWidth, pose.position.z + halfWidth } };
+        }
+        if (boundsRadius == 0.0f) UpdateBounds();
+        Vector3 center = Vector3Add(pose.position, boundsCenter);
+        Vector3 extent = { boundsRadius, boundsRadius, boundsRadius };
+        return { Vector3Subtract(center, extent), Vector3Add(center, extent) };
+    }
 
-    void Draw() {
-        models[animIndex].materials[0].shader = shader;
-        DrawModelEx(models[animIndex], position, { 0, 1, 0 }, rotation.y, scale, tint);
+    // Padded so animated limbs stay inside the bind-pose sphere
+    void UpdateBounds() {
+        BoundingBox box = assets[0]->bounds;
+        Vector3 center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+        Vector3 extent = Vector3Multiply(Vector3Subtract(box.max, box.min), scale);
+        boundsCenter = Vector3Multiply(center, scale);
+        boundsRadius = 0.75f * Vector3Length(extent);
+    }
 
+    // alpha blends between the last two simulation steps (see FixedTimestep)
+    void Interpolate(float alpha) {
+        renderPosition = Vector3Lerp(previousPosition, position, alpha);
     }
 
-    void PlayerController(Rope& rope, Camera Camera) {
-        float dt = GetFrameTime();
-        Vector3 moveDir = { 0 };
-        bool moving = false;
+    void Draw(const PlayerPose& pose) {
+        if (assets.empty()) return;
+        if (!assets[pose.animIndex]->ready) {
+            DrawCapsule(pose.position, Vector3Add(pose.position, { 0, height, 0 }), halfWidth, 8, 4, Fade(tint, 0.5f));
+            return;
+        }
+        Model& model = assets[pose.animIndex]->model;
+        animator.FinishSkinning(assets[pose.animIndex]);
+        DrawModelEx(model, pose.position, { 0, 1, 0 }, pose.rotation.y, scale, tint);
 
-        if (IsKeyDown(KEY_W) || IsKeyDown(KEY_UP)) { moveDir.z += 1.0f; moving = true; }
-        if (IsKeyDown(KEY_S) || IsKeyDown(KEY_DOWN)) { moveDir.z -= 1.0f; moving = true; }
-        if (IsKeyDown(KEY_A) || IsKeyDown(KEY_LEFT)) { moveDir.x += 1.0f; moving = true; }
-        if (IsKeyDown(KEY_D) || IsKeyDown(KEY_RIGHT)) { moveDir.x -= 1.0f; moving = true; }
+    }
 
-        if (IsKeyPressed(KEY_SPACE) && isGrounded) {
+    // Silhouette only, every material drawn with shader (the outline mask).
+    // Call after Draw, which finishes this frame's skinning.
+    void DrawMask(const PlayerPose& pose, Shader shader) {
+        if (assets.empty()) return;
+        if (!assets[pose.animIndex]->ready) {
+            BeginShaderMode(shader);
+            DrawCapsule(pose.position, Vector3Add(pose.position, { 0, height, 0 }), halfWidth, 8, 4, WHITE);
+            EndShaderMode();
+            return;
+        }
+        Model& model = assets[pose.animIndex]->model;
+        ownShaders.resize(model.materialCount);
+        for (int i = 0; i < model.materialCount; i++) {
+            ownShaders[i] = model.materials[i].shader;
+            model.materials[i].shader = shader;
+        }
+        DrawModelEx(model, pose.position, { 0, 1, 0 }, pose.rotation.y, scale, WHITE);
+        for (int i = 0; i < model.materialCount; i++) model.materials[i].shader = ownShaders[i];
+    }
+
+    // Where the solver moved the rope's player end this step (the rope has to
+    // weigh the player for it to move at all). The player follows it, swept
+    // against the blocks Update found, and keeps the move as velocity.
+    void FollowRope(Vector3 ropeEnd, float dt) {
+        Vector3 pull = Vector3Subtract(ropeEnd, position);
+        if (Vector3LengthSqr(pull) < 1e-12f) return;
+        Vector3 before = position;
+        int landedOn = -1;
+        Move(pull, false, landedOn);
+        velocity = Vector3Add(velocity, Vector3Scale(Vector3Subtract(position, before), 1.0f / dt));
+    }
+
+    void PlayerController(const PlayerInput& input, float dt) {
+        Vector3 moveDir = input.moveDir;
+        bool moving = moveDir.x != 0.0f || moveDir.z != 0.0f;
+
+        if (input.jump && isGrounded) {
             isGrounded = false;
             velocity.y = gravity * 0.6f;
         }
@@ -379,86 +819,229 @@ public:
             moveDir.x /= len;
             moveDir.z /= len;
 
-            // Check rope tension and block movement if needed
-            if (!(rope.IsTensionMaxed() && Vector3DotProduct(moveDir, rope.GetRopeDirection()) > 0.7f)) {
-                Quaternion targetAngle = QuaternionFromVector3ToVector3(position, Camera.position);
-                float camYaw = atan2f(Camera.target.x - Camera.position.x, Camera.target.z - Camera.position.z);
-                Quaternion camRotation = QuaternionFromAxisAngle({ 0, 1, 0 }, camYaw);
-                moveDir = Vector3RotateByQuaternion(moveDir, camRotation);
-                Vector3 movement = Vector3Scale(moveDir, moveSpeed * dt);
-                position = Vector3Add(position, movement);
-
-            }
+            Quaternion camRotation = QuaternionFromAxisAngle({ 0, 1, 0 }, input.cameraYaw);
+            moveDir = Vector3RotateByQuaternion(moveDir, camRotation);
+            Vector3 movement = Vector3Scale(moveDir, moveSpeed * dt);
+            moveDelta = Vector3Add(moveDelta, movement); // Update sweeps it against the blocks and the tether
 
-            rotation.y = LerpAngle(rotation.y, atan2f(moveDir.x, moveDir.z) * RAD2DEG, 0.1f);
+            rotation.y = LerpAngle(rotation.y, atan2f(moveDir.x, moveDir.z) * RAD2DEG, Clamp(12.0f * dt, 0.0f, 1.0f));
         }
 
     }
 
 
  
-	void OnCollision(Block& block, Ray ray) {
-		if (block.layer > 0) {
-			// Basic collision logic for blocks (layer > 0)
-			BoundingBox playerBox = GetTransformedBoundingBox(models[animIndex], position, scale);
-			BoundingBox blockBox = {
-				{block.position.x - block.scale.x / 2, block.position.y - block.scale.y / 2 , block.position.z - block.scale.z / 2},
-				{block.position.x + block.scale.x / 2, block.position.y + block.scale.y / 2 , block.position.z + block.scale.z / 2}
-			};
-
-			if (CheckCollisionBoxes(playerBox, blockBox)) {
-				// Basic landing logic  set player on top of block
-				isGrounded = true;
-				position.y = blockBox.max.y;
-				velocity.y = 0;
-
-				std::cout << "Player collided and landed on block.\n";
-			}
-		}
+private:
+    float lastSweep = 0.0f; // fraction of the move the last Sweep hit at
+    bool tethered = false;
+    Vector3 tetherAnchor = { 0, 0, 0 };
+    float tetherLength = 0.0f;
+
+    // Pulls the end of this step's move back onto the tether's sphere and
+    // drops the outward part of the velocity, which leaves the swing
+    void ApplyTether(Vector3& delta) {
+        Vector3 out = Vector3Subtract(Vector3Add(position, delta), tetherAnchor);
+        float distance = Vector3Length(out);
+        if (distance <= tetherLength || distance < 1e-6f) return;
+        Vector3 direction = Vector3Scale(out, 1.0f / distance);
+        delta = Vector3Subtract(delta, Vector3Scale(direction, distance - tetherLength));
+        float outward = Vector3DotProduct(velocity, direction);
+        if (outward > 0.0f) velocity = Vector3Subtract(velocity, Vector3Scale(direction, outward));
+    }
 
-		if (block.layer == 0) {
-            RayCollision col = GetRayCollisionMesh(ray, block.mesh, block.transform);
-            if (col.hit) {
-                float diff = position.y - (col.point.y -playerBox.min.y);
-                if (diff < 0.0) {
-                    position.y += Lerp(0, abs(diff), 0.5);
-                    velocity.y = 0;
-                    isGrounded = true;
-                }
+    // Index into nearby of the first obstacle the box runs into moving by
+    // delta, or -1. The fraction of delta goes to lastSweep.
+    int Sweep(Vector3 delta, Vector3* normal) {
+        BoundingBox box = GetCollisionBox(position);
+        int first = -1;
+        lastSweep = FLT_MAX;
+        for (int i = 0; i < (int)nearby.size(); i++) {
+            Vector3 n;
+            float t = nearby[i].Sweep(box, delta, &n);
+            if (t >= 0.0f && t < lastSweep) {
+                lastSweep = t;
+                first = i;
+                *normal = n;
             }
-		}
-	}
+        }
+        return first;
+    }
 
+    // Out of anything it ended up inside (a block was moved onto it, or it
+    // spawned there). Shallow overlaps leave upwards so the player stands on them.
+    void Depenetrate(int& landedOn) {
+        BoundingBox box = GetCollisionBox(position);
+        for (const Obstacle& obstacle : nearby) {
+            BoxContact contact = obstacle.Contact(box);
+            if (!contact.hit) continue;
+            float up = obstacle.box.max.y - position.y;
+            if (up <= stepHeight && obstacle.HasFlatTop()) contact = { true, { 0, 1, 0 }, up };
+            position = Vector3Add(position, Vector3Scale(contact.normal, contact.depth + skin));
+            if (contact.normal.y > 0.0f) {
+                isGrounded = true;
+                landedOn = obstacle.block;
+            }
+            box = GetCollisionBox(position);
+        }
+    }
+
+    // Collide and slide: move until the first hit, drop the part of the move
+    // that goes into the surface and carry on with the rest along it
+    void Move(Vector3 delta, bool wasGrounded, int& landedOn) {
+        for (int iteration = 0; iteration < 4; iteration++) {
+            if (Vector3LengthSqr(delta) < 1e-12f) return;
+            Vector3 normal;
+            int hit = Sweep(delta, &normal);
+            if (hit < 0) {
+                position = Vector3Add(position, delta);
+                return;
+            }
+            float t = lastSweep;
+            Vector3 contact = Vector3Add(position, Vector3Scale(delta, t));
+            Vector3 rest = Vector3Scale(delta, 1.0f - t);
+
+            if (normal.y == 0.0f && (wasGrounded || isGrounded) && velocity.y <= 0.0f && StepUp(nearby[hit], contact)) {
+                isGrounded = true;
+                landedOn = nearby[hit].block;
+                delta = { rest.x, 0.0f, rest.z };
+                continue;
+            }
+
+            position = Vector3Add(contact, Vector3Scale(normal, skin));
+            delta = Vector3Subtract(rest, Vector3Scale(normal, Vector3DotProduct(rest, normal)));
+            // Landing, a ceiling or a wall stops the velocity going into it
+            float into = Vector3DotProduct(velocity, normal);
+            if (into < 0.0f) velocity = Vector3Subtract(velocity, Vector3Scale(normal, into));
+            if (normal.y > 0.0f) {
+                isGrounded = true;
+                landedOn = nearby[hit].block;
+            }
+        }
+    }
+
+    // Onto the top of obstacle from contact, if it is low enough and there is room
+    bool StepUp(const Obstacle& obstacle, Vector3 contact) {
+        if (!obstacle.HasFlatTop()) return false;
+        float rise = obstacle.box.max.y - contact.y;
+        if (rise <= 0.0f || rise > stepHeight) return false;
+        Vector3 raised = { contact.x, obstacle.box.max.y + skin, contact.z };
+        BoundingBox box = GetCollisionBox(raised);
+        for (const Obstacle& other : nearby) {
+            if (other.Contact(box).hit) return false;
+        }
+        position = raised;
+        return true;
+    }
 };
 
 
 
-Block* onMouseCollision(vector<Block>& blocks, Ray ray, Camera camera) {
-    for (Block& block : blocks) {
-        BoundingBox box = {
-            {block.position.x - block.scale.x/2, block.position.y - block.scale.y/2 , block.position.z - block.scale.z/2},
-            {block.position.x + block.scale.x/2, block.position.y + block.scale.y/2 , block.position.z + block.scale.z/2}
-        };
-        BeginMode3D(camera);
-        DrawBoundingBox(box, RED);
-        EndMode3D();
-        RayCollision colData = GetRayCollisionMesh(ray, block.mesh, block.transform);
-        if (colData.hit) {
-            cout << "Collision" << endl;
-            return &block;
+PlayerInput ReadPlayerInput(const InputFrame& frame) {
+    PlayerInput input;
+    if (frame.IsDown(INPUT_FORWARD)) input.moveDir.z += 1.0f;
+    if (frame.IsDown(INPUT_BACK)) input.moveDir.z -= 1.0f;
+    if (frame.IsDown(INPUT_LEFT)) input.moveDir.x += 1.0f;
+    if (frame.IsDown(INPUT_RIGHT)) input.moveDir.x -= 1.0f;
+    input.jump = frame.IsPressed(INPUT_JUMP);
+    input.cameraYaw = frame.cameraYaw;
+    if (frame.IsDown(INPUT_REEL_IN)) input.reel -= 1.0f;
+    if (frame.IsDown(INPUT_REEL_OUT)) input.reel += 1.0f;
+    return input;
+}
+
+// Hit on the block's drawn shape. Unit-cube blocks are slab-tested as an
+// oriented box in their own space instead of as 12 mesh triangles, which
+// also works without the GPU mesh loaded. The direction is normalized first,
+// so maxDistance and the hit distance are both in world units.
+RayCollision GetRayCollisionBlock(Ray ray, Block& block, float maxDistance = FLT_MAX) {
+    ray.direction = Vector3Normalize(ray.direction);
+    if (block.terrain != nullptr) return block.terrain->Raycast(ray, maxDistance);
+    block.UpdateTransform();
+    if (block.mesh.vertexCount > 0) {
+        RayCollision hit = GetRayCollisionMesh(ray, block.mesh, block.transform);
+        if (hit.distance > maxDistance) hit.hit = false;
+        return hit;
+    }
+
+    RayCollision result = { 0 };
+    Matrix toLocal = MatrixInvert(block.transform);
+    Vector3 origin = Vector3Transform(ray.position, toLocal);
+    Vector3 end = Vector3Transform(Vector3Add(ray.position, ray.direction), toLocal);
+    Vector3 dir = Vector3Subtract(end, origin); // same t as the world ray
+
+    float tEnter = 0.0f, tExit = maxDistance;
+    int enterAxis = -1;
+    float enterSign = 0.0f;
+    const float* o = &origin.x;
+    const float* d = &dir.x;
+    for (int axis = 0; axis < 3; axis++) {
+        if (fabsf(d[axis]) < 1e-12f) {
+            if (o[axis] < -0.5f || o[axis] > 0.5f) return result;
+            continue;
         }
+        float t1 = (-0.5f - o[axis]) / d[axis];
+        float t2 = (0.5f - o[axis]) / d[axis];
+        float sign = -1.0f;
+        if (t1 > t2) { float tmp = t1; t1 = t2; t2 = tmp; sign = 1.0f; }
+        if (t1 > tEnter) { tEnter = t1; enterAxis = axis; enterSign = sign; }
+        tExit = fminf(tExit, t2);
+        if (tEnter > tExit) return result;
     }
-    return nullptr;
+    if (enterAxis < 0) return result; // starts inside the block
+
+    Vector3 localNormal = { 0, 0, 0 };
+    (&localNormal.x)[enterAxis] = enterSign;
+    Matrix normalMatrix = MatrixTranspose(toLocal);
+    normalMatrix.m12 = normalMatrix.m13 = normalMatrix.m14 = 0.0f;
+    result.hit = true;
+    result.distance = tEnter;
+    result.point = Vector3Add(ray.position, Vector3Scale(ray.direction, tEnter));
+    result.normal = Vector3Normalize(Vector3Transform(localNormal, normalMatrix));
+    return result;
+}
+
+// Closest block under the ray, or nullptr. Only blocks whose bounds the ray
+// crosses are tested; their indices go to tested when it is given.
+Block* PickBlock(vector<Block>& blocks, const AABBTree& broadphase, Ray ray, float* hitDistance = nullptr, vector<int>* tested = nullptr) {
+    Block* closest = nullptr;
+    float closestDistance = FLT_MAX;
+    ray.direction = Vector3Normalize(ray.direction); // the tree's t is then a distance too
+    broadphase.RayQuery(ray, closestDistance, [&](int blockIndex) {
+        Block& block = blocks[blockIndex];
+        if (tested) tested->push_back(blockIndex);
+        RayCollision colData = GetRayCollisionBlock(ray, block, closestDistance);
+        if (colData.hit && colData.distance < closestDistance) {
+            closest = &block;
+            closestDistance = colData.distance;
+        }
+        return closestDistance;
+    });
+    if (hitDistance) *hitDistance = closestDistance;
+    return closest;
+}
+
+// Picking from the main loop: also outlines every block the ray was tested against
+Block* onMouseCollision(vector<Block>& blocks, const AABBTree& broadphase, Ray ray, Camera camera) {
+    vector<int> tested;
+    float distance;
+    Block* picked = PickBlock(blocks, broadphase, ray, &distance, &tested);
+    BeginMode3D(camera);
+    for (int blockIndex : tested) DrawBoundingBox(blocks[blockIndex].GetCollisionBox(), RED);
+    EndMode3D();
+    if (picked) LOG("Picked %s at %.2f\n", picked->name.c_str(), distance);
+    return picked;
 }
 
-void ShowBlocksUI(Block* block) {
-    if (block == nullptr) return;
+// Returns true when the block was moved, rotated or scaled this frame
+bool ShowBlocksUI(Block* block) {
+    if (block == nullptr) return false;
 
     ImGui::Begin("Block Editor");
 
-    ImGui::DragFloat3("Position", (float*)&block->position, 0.1f);
-    ImGui::DragFloat3("Rotation", (float*)&block->rotation, 0.1f);
-    ImGui::DragFloat3("Scale", (float*)&block->scale, 0.1f, 0.1f, 10.0f);
+    bool moved = false;
+    moved |= ImGui::DragFloat3("Position", (float*)&block->position, 0.1f);
+    moved |= ImGui::DragFloat3("Rotation", (float*)&block->rotation, 0.1f);
+    moved |= ImGui::DragFloat3("Scale", (float*)&block->scale, 0.1f, 0.1f, 10.0f);
 
     Vector3 normalizedColor = {
         block->color.r / 255.0f,
@@ -473,4 +1056,5 @@ void ShowBlocksUI(Block* block) {
     }
 
     ImGui::End();
+    return moved;
 }
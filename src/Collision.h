@@ -0,0 +1,306 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "Transforms.h"
+#include <cmath>
+#include <cfloat>
+
+// Box with its own axes. Local coordinates run from -half to +half.
+struct OrientedBox {
+    Vector3 center = { 0, 0, 0 };
+    Vector3 axis[3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } }; // unit length
+    Vector3 half = { 0.5f, 0.5f, 0.5f };
+
+    Vector3 ToLocal(Vector3 p) const {
+        Vector3 d = Vector3Subtract(p, center);
+        return { Vector3DotProduct(d, axis[0]), Vector3DotProduct(d, axis[1]), Vector3DotProduct(d, axis[2]) };
+    }
+
+    Vector3 ToWorld(Vector3 local) const {
+        Vector3 p = center;
+        p = Vector3Add(p, Vector3Scale(axis[0], local.x));
+        p = Vector3Add(p, Vector3Scale(axis[1], local.y));
+        p = Vector3Add(p, Vector3Scale(axis[2], local.z));
+        return p;
+    }
+
+    // Smallest axis-aligned box around it
+    BoundingBox GetBounds() const {
+        Vector3 extent;
+        extent.x = fabsf(axis[0].x) * half.x + fabsf(axis[1].x) * half.y + fabsf(axis[2].x) * half.z;
+        extent.y = fabsf(axis[0].y) * half.x + fabsf(axis[1].y) * half.y + fabsf(axis[2].y) * half.z;
+        extent.z = fabsf(axis[0].z) * half.x + fabsf(axis[1].z) * half.y + fabsf(axis[2].z) * half.z;
+        return { Vector3Subtract(center, extent), Vector3Add(center, extent) };
+    }
+};
+
+// Same rotation convention as ComposeTransform (degrees)
+OrientedBox MakeOrientedBox(Vector3 center, Vector3 rotation, Vector3 size) {
+    Matrix m = ComposeTransform(center, rotation, { 1, 1, 1 });
+    OrientedBox box;
+    box.center = center;
+    box.axis[0] = { m.m0, m.m1, m.m2 };
+    box.axis[1] = { m.m4, m.m5, m.m6 };
+    box.axis[2] = { m.m8, m.m9, m.m10 };
+    box.half = Vector3Scale(size, 0.5f);
+    return box;
+}
+
+struct BoxContact {
+    bool hit = false;
+    Vector3 normal = { 0, 1, 0 }; // out of the box
+    float depth = 0.0f;           // how far to move along normal to just touch
+};
+
+// Sphere against box. A center inside the box leaves through the nearest face.
+BoxContact SphereBoxContact(const OrientedBox& box, Vector3 p, float radius) {
+    BoxContact contact;
+    Vector3 local = box.ToLocal(p);
+    float l[3] = { local.x, local.y, local.z };
+    float h[3] = { box.half.x, box.half.y, box.half.z };
+    float c[3];
+    bool inside = true;
+    for (int a = 0; a < 3; a++) {
+        c[a] = Clamp(l[a], -h[a], h[a]);
+        if (c[a] != l[a]) inside = false;
+    }
+
+    if (inside) {
+        int best = 0;
+        float bestGap = FLT_MAX;
+        for (int a = 0; a < 3; a++) {
+            float gap = h[a] - fabsf(l[a]);
+            if (gap < bestGap) { bestGap = gap; best = a; }
+        }
+        contact.hit = true;
+        contact.normal = Vector3Scale(box.axis[best], l[best] >= 0.0f ? 1.0f : -1.0f);
+        contact.depth = bestGap + radius;
+        return contact;
+    }
+
+    Vector3 d = { l[0] - c[0], l[1] - c[1], l[2] - c[2] };
+    float distSq = Vector3DotProduct(d, d);
+    if (distSq >= radius * radius) return contact;
+    float dist = sqrtf(distSq);
+    contact.hit = true;
+    Vector3 offset = Vector3Subtract(box.ToWorld(d), box.center); // d rotated into world space
+    contact.normal = Vector3Scale(offset, 1.0f / fmaxf(dist, 1e-9f));
+    contact.depth = radius - dist;
+    return contact;
+}
+
+// Where a point moving from -> to first enters the box grown by radius, as a
+// fraction of the move, or -1 if it doesn't. from must start outside. Corners
+// are treated as square, which only errs towards catching the hit.
+float SweepPointBox(const OrientedBox& box, Vector3 from, Vector3 to, float radius, Vector3* normal) {
+    Vector3 a = box.ToLocal(from);
+    Vector3 b = box.ToLocal(to);
+    float o[3] = { a.x, a.y, a.z };
+    float d[3] = { b.x - a.x, b.y - a.y, b.z - a.z };
+    float h[3] = { box.half.x + radius, box.half.y + radius, box.half.z + radius };
+
+    float tEnter = 0.0f, tExit = 1.0f;
+    int enterAxis = -1;
+    float enterSign = 1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (fabsf(d[axis]) < 1e-9f) {
+            if (o[axis] < -h[axis] || o[axis] > h[axis]) return -1.0f;
+            continue;
+        }
+        float t1 = (-h[axis] - o[axis]) / d[axis];
+        float t2 = (h[axis] - o[axis]) / d[axis];
+        float sign = -1.0f;  // entering through the -h face
+        if (t1 > t2) { float t = t1; t1 = t2; t2 = t; sign = 1.0f; }
+        if (t1 > tEnter) { tEnter = t1; enterAxis = axis; enterSign = sign; }
+        tExit = fminf(tExit, t2);
+        if (tEnter > tExit) return -1.0f;
+    }
+    if (enterAxis < 0) return -1.0f; // started inside
+    *normal = Vector3Scale(box.axis[enterAxis], enterSign);
+    return tEnter;
+}
+
+// Contact for a sphere that moved from -> to in one step. If the move came in
+// from outside, it is pushed back out of the face it entered through, even if
+// it went all the way through a thin box; otherwise out of the nearest face.
+BoxContact SweptSphereBoxContact(const OrientedBox& box, Vector3 from, Vector3 to, float radius) {
+    Vector3 normal;
+    float extra = 0.0f;
+    float t = SweepPointBox(box, from, to, radius, &normal);
+    if (t < 0.0f) {
+        // Already touching last step: sweep against the box itself
+        t = SweepPointBox(box, from, to, 0.0f, &normal);
+        extra = radius;
+    }
+    if (t >= 0.0f) {
+        Vector3 entry = Vector3Lerp(from, to, t);
+        float depth = Vector3DotProduct(Vector3Subtract(entry, to), normal) + extra;
+        if (depth > 0.0f) {
+            BoxContact contact;
+            contact.hit = true;
+            contact.normal = normal;
+            contact.depth = depth;
+            return contact;
+        }
+    }
+    return SphereBoxContact(box, to, radius);
+}
+
+// Where segment a-b cuts through the box grown by radius: the parameter of
+// the middle of the part inside, where pushing it out helps most, or -1 if it
+// misses. Corners are treated as square.
+float SegmentThroughBox(const OrientedBox& box, Vector3 a, Vector3 b, float radius) {
+    Vector3 la = box.ToLocal(a);
+    Vector3 lb = box.ToLocal(b);
+    float o[3] = { la.x, la.y, la.z };
+    float d[3] = { lb.x - la.x, lb.y - la.y, lb.z - la.z };
+    float h[3] = { box.half.x + radius, box.half.y + radius, box.half.z + radius };
+
+    float tEnter = 0.0f, tExit = 1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (fabsf(d[axis]) < 1e-9f) {
+            if (o[axis] < -h[axis] || o[axis] > h[axis]) return -1.0f;
+            continue;
+        }
+        float t1 = (-h[axis] - o[axis]) / d[axis];
+        float t2 = (h[axis] - o[axis]) / d[axis];
+        if (t1 > t2) { float t = t1; t1 = t2; t2 = t; }
+        tEnter = fmaxf(tEnter, t1);
+        tExit = fminf(tExit, t2);
+        if (tEnter > tExit) return -1.0f;
+    }
+    return (tEnter + tExit) * 0.5f;
+}
+
+// Axis-aligned box against box: the way out of target for a that moves it the
+// least, and how far. Boxes that only touch don't hit.
+BoxContact BoxBoxContact(const BoundingBox& a, const BoundingBox& target) {
+    BoxContact contact;
+    float lowOut[3] = { a.max.x - target.min.x, a.max.y - target.min.y, a.max.z - target.min.z };
+    float highOut[3] = { target.max.x - a.min.x, target.max.y - a.min.y, target.max.z - a.min.z };
+    float best = FLT_MAX;
+    for (int axis = 0; axis < 3; axis++) {
+        if (lowOut[axis] <= 0.0f || highOut[axis] <= 0.0f) return contact;
+        Vector3 normal = { 0, 0, 0 };
+        if (lowOut[axis] < best) { best = lowOut[axis]; (&normal.x)[axis] = -1.0f; contact.normal = normal; }
+        normal = { 0, 0, 0 };
+        if (highOut[axis] < best) { best = highOut[axis]; (&normal.x)[axis] = 1.0f; contact.normal = normal; }
+    }
+    contact.hit = true;
+    contact.depth = best;
+    return contact;
+}
+
+// When box a moving by delta first touches target, as a fraction of delta, or
+// -1 if it doesn't this move. normal is the face of target it runs into.
+// Boxes that already overlap don't count; separate them with BoxBoxContact.
+float SweepBoxBox(const BoundingBox& a, Vector3 delta, const BoundingBox& target, Vector3* normal) {
+    float aMin[3] = { a.min.x, a.min.y, a.min.z };
+    float aMax[3] = { a.max.x, a.max.y, a.max.z };
+    float bMin[3] = { target.min.x, target.min.y, target.min.z };
+    float bMax[3] = { target.max.x, target.max.y, target.max.z };
+    float d[3] = { delta.x, delta.y, delta.z };
+
+    float tEnter = -FLT_MAX, tExit = FLT_MAX;
+    int enterAxis = -1;
+    float enterSign = 1.0f;
+    for (int axis = 0; axis < 3; axis++) {
+        if (fabsf(d[axis]) < 1e-9f) {
+            // Not moving on this axis: has to overlap on it already
+            if (aMax[axis] <= bMin[axis] || aMin[axis] >= bMax[axis]) return -1.0f;
+            continue;
+        }
+        float t1 = (bMin[axis] - aMax[axis]) / d[axis];
+        float t2 = (bMax[axis] - aMin[axis]) / d[axis];
+        float sign = -1.0f;  // running into the min face
+        if (t1 > t2) { float t = t1; t1 = t2; t2 = t; sign = 1.0f; }
+        if (t1 > tEnter) { tEnter = t1; enterAxis = axis; enterSign = sign; }
+        tExit = fminf(tExit, t2);
+    }
+    if (enterAxis < 0 || tEnter >= tExit || tEnter < 0.0f || tEnter > 1.0f) return -1.0f;
+    Vector3 n = { 0, 0, 0 };
+    (&n.x)[enterAxis] = enterSign;
+    *normal = n;
+    return tEnter;
+}
+
+// Axes that can separate an axis-aligned box from target: the world axes,
+// target's axes and their cross products (skipped where they vanish).
+// Returns how many went to axes.
+int SeparatingAxes(const OrientedBox& target, Vector3 axes[15]) {
+    const Vector3 world[3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    int count = 0;
+    for (int i = 0; i < 3; i++) axes[count++] = world[i];
+    for (int i = 0; i < 3; i++) axes[count++] = target.axis[i];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            Vector3 axis = Vector3CrossProduct(world[i], target.axis[j]);
+            float lengthSq = Vector3LengthSqr(axis);
+            if (lengthSq > 1e-6f) axes[count++] = Vector3Scale(axis, 1.0f / sqrtf(lengthSq));
+        }
+    }
+    return count;
+}
+
+// Distance between the two boxes' centers along axis, and how far they
+// reach along it together
+void ProjectBoxes(const BoundingBox& a, const OrientedBox& target, Vector3 axis, float* offset, float* reach) {
+    Vector3 center = Vector3Scale(Vector3Add(a.min, a.max), 0.5f);
+    Vector3 half = Vector3Scale(Vector3Subtract(a.max, a.min), 0.5f);
+    *offset = Vector3DotProduct(Vector3Subtract(center, target.center), axis);
+    *reach = fabsf(axis.x) * half.x + fabsf(axis.y) * half.y + fabsf(axis.z) * half.z
+        + fabsf(Vector3DotProduct(target.axis[0], axis)) * target.half.x
+        + fabsf(Vector3DotProduct(target.axis[1], axis)) * target.half.y
+        + fabsf(Vector3DotProduct(target.axis[2], axis)) * target.half.z;
+}
+
+// BoxBoxContact against a rotated box, by separating axes
+BoxContact BoxBoxContact(const BoundingBox& a, const OrientedBox& target) {
+    BoxContact contact;
+    Vector3 axes[15];
+    int count = SeparatingAxes(target, axes);
+    float best = FLT_MAX;
+    Vector3 normal = { 0, 1, 0 };
+    for (int i = 0; i < count; i++) {
+        float offset, reach;
+        ProjectBoxes(a, target, axes[i], &offset, &reach);
+        float depth = reach - fabsf(offset);
+        if (depth <= 0.0f) return contact;
+        if (depth < best) {
+            best = depth;
+            normal = offset >= 0.0f ? axes[i] : Vector3Negate(axes[i]);
+        }
+    }
+    contact.hit = true;
+    contact.normal = normal;
+    contact.depth = best;
+    return contact;
+}
+
+// SweepBoxBox against a rotated box, by separating axes
+float SweepBoxBox(const BoundingBox& a, Vector3 delta, const OrientedBox& target, Vector3* normal) {
+    Vector3 axes[15];
+    int count = SeparatingAxes(target, axes);
+    float tEnter = -FLT_MAX, tExit = FLT_MAX;
+    int enterAxis = -1;
+    float enterSign = 1.0f;
+    for (int i = 0; i < count; i++) {
+        float offset, reach;
+        ProjectBoxes(a, target, axes[i], &offset, &reach);
+        float d = Vector3DotProduct(delta, axes[i]);
+        if (fabsf(d) < 1e-9f) {
+            // Not moving along this axis: has to overlap on it already
+            if (fabsf(offset) >= reach) return -1.0f;
+            continue;
+        }
+        float t1 = (-reach - offset) / d;
+        float t2 = (reach - offset) / d;
+        float sign = -1.0f;  // coming in from the negative side
+        if (t1 > t2) { float t = t1; t1 = t2; t2 = t; sign = 1.0f; }
+        if (t1 > tEnter) { tEnter = t1; enterAxis = i; enterSign = sign; }
+        tExit = fminf(tExit, t2);
+    }
+    if (enterAxis < 0 || tEnter >= tExit || tEnter < 0.0f || tEnter > 1.0f) return -1.0f;
+    *normal = Vector3Scale(axes[enterAxis], enterSign);
+    return tEnter;
+}
@@ -0,0 +1,29 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;   // Outline mask: object id in red, 0 where there is none
+uniform vec2 resolution;      // Size of texture0 in texels
+uniform float thickness;      // Outline width in pixels
+
+// Output fragment color
+out vec4 finalColor;
+
+// Horizontal half of the outline's dilate: the highest id within thickness
+// pixels to either side, one tap per texel so nothing thin is skipped.
+// Outline.frag finishes it vertically.
+void main()
+{
+    float texel = 1.0 / resolution.x;
+    int reach = max(int(thickness + 0.5), 1);
+    float id = texture(texture0, fragTexCoord).r;
+    for (int i = 1; i <= reach; i++)
+    {
+        id = max(id, texture(texture0, fragTexCoord + vec2(float(i) * texel, 0.0)).r);
+        id = max(id, texture(texture0, fragTexCoord - vec2(float(i) * texel, 0.0)).r);
+    }
+    finalColor = vec4(id, 0.0, 0.0, 1.0);
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include <cmath>
+
+// Same clip distances BeginMode3D uses for perspective cameras
+const float cameraNearPlane = 0.01f;
+const float cameraFarPlane = 1000.0f;
+
+struct Plane {
+    Vector3 normal;
+    float d;
+    float Distance(Vector3 p) const { return Vector3DotProduct(normal, p) + d; }
+};
+
+// View frustum as six inward-facing planes. Built from matrices only, so it
+// works without a window.
+struct Frustum {
+    Plane planes[6]; // left, right, bottom, top, near, far
+
+    // Conservative: may keep a box that is just outside a corner, never drops a visible one
+    bool IntersectsBox(const BoundingBox& box) const {
+        for (const Plane& plane : planes) {
+            // Corner furthest along the plane normal
+            Vector3 p = {
+                plane.normal.x >= 0.0f ? box.max.x : box.min.x,
+                plane.normal.y >= 0.0f ? box.max.y : box.min.y,
+                plane.normal.z >= 0.0f ? box.max.z : box.min.z
+            };
+            if (plane.Distance(p) < 0.0f) return false;
+        }
+        return true;
+    }
+
+    // -1 outside, 0 crossing a plane, 1 wholly inside
+    int ClassifyBox(const BoundingBox& box) const {
+        int result = 1;
+        for (const Plane& plane : planes) {
+            Vector3 furthest = {
+                plane.normal.x >= 0.0f ? box.max.x : box.min.x,
+                plane.normal.y >= 0.0f ? box.max.y : box.min.y,
+                plane.normal.z >= 0.0f ? box.max.z : box.min.z
+            };
+            if (plane.Distance(furthest) < 0.0f) return -1;
+            Vector3 nearest = {
+                plane.normal.x >= 0.0f ? box.min.x : box.max.x,
+                plane.normal.y >= 0.0f ? box.min.y : box.max.y,
+                plane.normal.z >= 0.0f ? box.min.z : box.max.z
+            };
+            if (plane.Distance(nearest) < 0.0f) result = 0;
+        }
+        return result;
+    }
+
+    bool IntersectsSphere(Vector3 center, float radius) const {
+        for (const Plane& plane : planes) {
+            if (plane.Distance(center) < -radius) return false;
+        }
+        return true;
+    }
+};
+
+Matrix GetCameraViewProjection(const Camera3D& camera, float aspect) {
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    Matrix projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect, cameraNearPlane, cameraFarPlane);
+    return MatrixMultiply(view, projection);
+}
+
+// Gribb/Hartmann plane extraction from the rows of the view-projection matrix
+Frustum ExtractFrustum(Matrix m) {
+    Vector4 row0 = { m.m0, m.m4, m.m8, m.m12 };
+    Vector4 row1 = { m.m1, m.m5, m.m9, m.m13 };
+    Vector4 row2 = { m.m2, m.m6, m.m10, m.m14 };
+    Vector4 row3 = { m.m3, m.m7, m.m11, m.m15 };
+    Vector4 raw[6] = {
+        { row3.x + row0.x, row3.y + row0.y, row3.z + row0.z, row3.w + row0.w },
+        { row3.x - row0.x, row3.y - row0.y, row3.z - row0.z, row3.w - row0.w },
+        { row3.x + row1.x, row3.y + row1.y, row3.z + row1.z, row3.w + row1.w },
+        { row3.x - row1.x, row3.y - row1.y, row3.z - row1.z, row3.w - row1.w },
+        { row3.x + row2.x, row3.y + row2.y, row3.z + row2.z, row3.w + row2.w },
+        { row3.x - row2.x, row3.y - row2.y, row3.z - row2.z, row3.w - row2.w },
+    };
+
+    Frustum frustum;
+    for (int i = 0; i < 6; i++) {
+        float length = sqrtf(raw[i].x * raw[i].x + raw[i].y * raw[i].y + raw[i].z * raw[i].z);
+        frustum.planes[i] = { { raw[i].x / length, raw[i].y / length, raw[i].z / length }, raw[i].w / length };
+    }
+    return frustum;
+}
+
+Frustum ExtractFrustum(const Camera3D& camera, float aspect) {
+    return ExtractFrustum(GetCameraViewProjection(camera, aspect));
+}
+
+// Axis-aligned box around a transformed box (Arvo's method)
+BoundingBox TransformBox(BoundingBox box, Matrix m) {
+    float local[3][2] = { { box.min.x, box.max.x }, { box.min.y, box.max.y }, { box.min.z, box.max.z } };
+    float rows[3][4] = {
+        { m.m0, m.m4, m.m8, m.m12 },
+        { m.m1, m.m5, m.m9, m.m13 },
+        { m.m2, m.m6, m.m10, m.m14 }
+    };
+    float outMin[3], outMax[3];
+    for (int i = 0; i < 3; i++) {
+        outMin[i] = outMax[i] = rows[i][3];
+        for (int j = 0; j < 3; j++) {
+            float a = rows[i][j] * local[j][0];
+            float b = rows[i][j] * local[j][1];
+            outMin[i] += fminf(a, b);
+            outMax[i] += fmaxf(a, b);
+        }
+    }
+    return { { outMin[0], outMin[1], outMin[2] }, { outMax[0], outMax[1], outMax[2] } };
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include "raylib.h"
+#include "Log.h"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// Buttons the game reacts to, as bits so a frame's input is two words
+enum InputButton : uint16_t {
+    INPUT_FORWARD = 1 << 0,
+    INPUT_BACK = 1 << 1,
+    INPUT_LEFT = 1 << 2,
+    INPUT_RIGHT = 1 << 3,
+    INPUT_JUMP = 1 << 4,
+    INPUT_POINTER = 1 << 5,         // left mouse: orbit camera, pick a block
+    INPUT_FULLSCREEN = 1 << 6,
+    INPUT_CAMERA_FOLLOW = 1 << 7,
+    INPUT_CAMERA_ORBIT = 1 << 8,
+    INPUT_FOCUS_SELECTED = 1 << 9,
+    INPUT_REEL_IN = 1 << 10,
+    INPUT_REEL_OUT = 1 << 11,
+};
+
+// Everything one rendered frame reads from the devices, plus the few results
+// that depend on rendered state (camera, picking) so a replay doesn't need a
+// camera or GPU to reproduce them. Written to disk as is.
+struct InputFrame {
+    float frameTime = 0.0f;
+    uint16_t held = 0;              // InputButton bits down this frame
+    uint16_t pressed = 0;           // InputButton bits that went down this frame
+    Vector2 mouseDelta = { 0, 0 };
+    Vector2 mousePosition = { 0, 0 };
+    float wheel = 0.0f;
+    float cameraYaw = 0.0f;         // radians, camera forward around Y when the frame started
+    int32_t attachBlock = -1;       // block index the rope was attached to this frame
+    Vector3 playerPosition = { 0, 0, 0 }; // after the frame's simulation, checked on replay
+
+    bool IsDown(InputButton button) const { return (held & button) != 0; }
+    bool IsPressed(InputButton button) const { return (pressed & button) != 0; }
+    bool IsMoving() const { return (held & (INPUT_FORWARD | INPUT_BACK | INPUT_LEFT | INPUT_RIGHT)) != 0; }
+};
+static_assert(sizeof(InputFrame) == 48, "InputFrame is the on-disk record");
+
+// Live devices
+InputFrame PollInput(const Camera& camera) {
+    struct Binding { InputButton button; int key; int altKey; };
+    static const Binding bindings[] = {
+        { INPUT_FORWARD, KEY_W, KEY_UP },
+        { INPUT_BACK, KEY_S, KEY_DOWN },
+        { INPUT_LEFT, KEY_A, KEY_LEFT },
+        { INPUT_RIGHT, KEY_D, KEY_RIGHT },
+        { INPUT_JUMP, KEY_SPACE, KEY_NULL },
+        { INPUT_FULLSCREEN, KEY_F, KEY_NULL },
+        { INPUT_CAMERA_FOLLOW, KEY_KP_ADD, KEY_NULL },
+        { INPUT_CAMERA_ORBIT, KEY_KP_SUBTRACT, KEY_NULL },
+        { INPUT_FOCUS_SELECTED, KEY_E, KEY_NULL },
+        { INPUT_REEL_IN, KEY_Q, KEY_NULL },
+        { INPUT_REEL_OUT, KEY_Z, KEY_NULL },
+    };
+
+    InputFrame frame;
+    frame.frameTime = GetFrameTime();
+    for (const Binding& binding : bindings) {
+        if (IsKeyDown(binding.key) || (binding.altKey != KEY_NULL && IsKeyDown(binding.altKey))) frame.held |= binding.button;
+        if (IsKeyPressed(binding.key) || (binding.altKey != KEY_NULL && IsKeyPressed(binding.altKey))) frame.pressed |= binding.button;
+    }
+    if (IsMouseButtonDown(MOUSE_BUTTON_LEFT)) frame.held |= INPUT_POINTER;
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) frame.pressed |= INPUT_POINTER;
+    frame.mouseDelta = GetMouseDelta();
+    frame.mousePosition = GetMousePosition();
+    frame.wheel = GetMouseWheelMove();
+    frame.cameraYaw = atan2f(camera.target.x - camera.position.x, camera.target.z - camera.position.z);
+    return frame;
+}
+
+// A recorded session: a short header, then one InputFrame per rendered frame
+struct InputLog {
+    static constexpr uint32_t version = 1;
+    float stepRate = 120.0f;        // FixedTimestep rate it was recorded at
+    std::vector<InputFrame> frames;
+
+    bool Save(const char* path) const {
+        FILE* file = fopen(path, "wb");
+        if (!file) return false;
+        uint32_t count = (uint32_t)frames.size();
+        bool ok = fwrite("GRIN", 1, 4, file) == 4
+            && fwrite(&version, sizeof(version), 1, file) == 1
+            && fwrite(&stepRate, sizeof(stepRate), 1, file) == 1
+            && fwrite(&count, sizeof(count), 1, file) == 1
+            && fwrite(frames.data(), sizeof(InputFrame), count, file) == count;
+        fclose(file);
+        return ok;
+    }
+
+    bool Load(const char* path) {
+        FILE* file = fopen(path, "rb");
+        if (!file) return false;
+        char magic[4];
+        uint32_t fileVersion = 0, count = 0;
+        bool ok = fread(magic, 1, 4, file) == 4 && memcmp(magic, "GRIN", 4) == 0
+            && fread(&fileVersion, sizeof(fileVersion), 1, file) == 1 && fileVersion == version
+            && fread(&stepRate, sizeof(stepRate), 1, file) == 1
+            && fread(&count, sizeof(count), 1, file) == 1;
+        if (ok) {
+            frames.resize(count);
+            ok = fread(frames.data(), sizeof(InputFrame), count, file) == count;
+        }
+        fclose(file);
+        if (!ok) frames.clear();
+        return ok;
+    }
+};
+
+// Where the game loop gets its input: the devices, the devices while writing
+// them to a log, or a log played back. Replays are only exact when the session
+// starts from a fully loaded level and nothing is edited through ImGui.
+class InputSource {
+public:
+    ~InputSource() { Finish(); }
+
+    void Record(const char* path, float stepRate) {
+        recordPath = path;
+        recorded = InputLog();
+        recorded.stepRate = stepRate;
+        recording = true;
+    }
+
+    bool Replay(const char* path) {
+        if (!replay.Load(path)) {
+            LOG("Can't read input log %s\n", path);
+            return false;
+        }
+        cursor = 0;
+        diverged = false;
+        replaying = true;
+        return true;
+    }
+
+    bool IsRecording() const { return recording; }
+    bool IsReplaying() const { return replaying; }
+    float GetReplayStepRate() const { return replay.stepRate; }
+
+    // Once at the top of every frame
+    InputFrame Poll(const Camera& camera) {
+        if (replaying && cursor >= replay.frames.size()) {
+            LOG("Replay finished after %d frames%s\n", (int)replay.frames.size(), diverged ? " (diverged)" : "");
+            replaying = false;
+        }
+        if (replaying) return replay.frames[cursor];
+        return PollInput(camera);
+    }
+
+    // Once the frame's simulation has run. frame carries what Poll returned,
+    // with attachBlock filled in if the rope was attached.
+    void EndFrame(InputFrame frame, Vector3 playerPosition) {
+        frame.playerPosition = playerPosition;
+        if (recording) recorded.frames.push_back(frame);
+        if (!replaying) return;
+        Vector3 expected = replay.frames[cursor].playerPosition;
+        if (!diverged && memcmp(&expected, &playerPosition, sizeof(Vector3)) != 0) {
+            LOG("Replay diverged at frame %d\n", (int)cursor);
+            diverged = true;
+        }
+        cursor++;
+    }
+
+    // Writes the recording, if there is one
+    void Finish() {
+        if (!recording) return;
+        recording = false;
+        if (recorded.Save(recordPath.c_str())) LOG("Recorded %d frames to %s\n", (int)recorded.frames.size(), recordPath.c_str());
+        else LOG("Can't write input log %s\n", recordPath.c_str());
+    }
+
+private:
+    InputLog recorded;
+    InputLog replay;
+    std::string recordPath;
+    size_t cursor = 0;
+    bool recording = false;
+    bool replaying = false;
+    bool diverged = false;
+};
@@ -0,0 +1,143 @@
+#pragma once
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include "Profiler.h"
+
+// Counts the outstanding jobs of one batch. Wait on it until it reaches zero.
+struct JobCounter {
+    std::atomic<int> pending{ 0 };
+    bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+// Fixed pool of worker threads. Waiting threads help run queued jobs instead
+// of blocking, so jobs may wait on other jobs. Background jobs (file loads)
+// only run on workers, so a frame waiting on short jobs never picks one up.
+class JobSystem {
+public:
+    explicit JobSystem(int workerCount) {
+        Profiler::Instance(); // workers record zones, so it has to outlive them
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back([this, i] { WorkerLoop(i); });
+        }
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& worker : workers) worker.join();
+    }
+
+    // One worker per core, leaving the main thread its own core
+    static JobSystem& Get() {
+        static JobSystem instance(std::max(1, (int)std::thread::hardware_concurrency() - 1));
+        return instance;
+    }
+
+    int GetWorkerCount() const { return (int)workers.size(); }
+
+    void Run(JobCounter& counter, std::function<void()> job) {
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back({ std::move(job), &counter });
+        }
+        wake.notify_one();
+    }
+
+    // Workers take these once the regular queue is empty
+    void RunBackground(JobCounter& counter, std::function<void()> job) {
+        counter.pending.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            background.push_back({ std::move(job), &counter });
+        }
+        wake.notify_one();
+    }
+
+    void Wait(JobCounter& counter) {
+        while (!counter.IsDone()) {
+            if (!TryRunOne()) std::this_thread::yield();
+        }
+    }
+
+    // Calls fn(i) for every i in [0, count) and returns when all are done. The
+    // caller and up to one job per worker claim grain-sized chunks from a shared
+    // cursor, so a thread that finishes early takes work the others haven't
+    // reached and uneven items balance out.
+    template <typename F>
+    void ParallelFor(int count, int grain, F&& fn) {
+        if (count <= 0) return;
+        grain = std::max(grain, 1);
+        std::atomic<int> next{ 0 };
+        auto drain = [&] {
+            while (true) {
+                int begin = next.fetch_add(grain, std::memory_order_relaxed);
+                if (begin >= count) return;
+                int end = std::min(begin + grain, count);
+                for (int i = begin; i < end; i++) fn(i);
+            }
+        };
+        int chunks = (count + grain - 1) / grain;
+        int helpers = std::min(GetWorkerCount(), chunks - 1);
+        JobCounter counter;
+        for (int i = 0; i < helpers; i++) Run(counter, drain);
+        drain();
+        Wait(counter);
+    }
+
+private:
+    struct Job {
+        std::function<void()> work;
+        JobCounter* counter;
+    };
+
+    std::vector<std::thread> workers;
+    std::deque<Job> queue;
+    std::deque<Job> background;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    bool TryRunOne() {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (queue.empty()) return false;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+        Execute(job);
+        return true;
+    }
+
+    static void Execute(Job& job) {
+        job.work();
+        job.counter->pending.fetch_sub(1, std::memory_order_release);
+    }
+
+    void WorkerLoop(int index) {
+        Profiler::Instance().SetThreadName("Worker " + std::to_string(index));
+        while (true) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !queue.empty() || !background.empty(); });
+                if (stopping && queue.empty() && background.empty()) return;
+                std::deque<Job>& source = queue.empty() ? background : queue;
+                job = std::move(source.front());
+                source.pop_front();
+            }
+            Execute(job);
+        }
+    }
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include "raylib.h"
+#include "World.h"
+#include "Terrain.h"
+
+// The playable level. The game and headless replays both build it from here
+// so a recorded session runs against the same blocks and spawn.
+const char* const levelHeightmap = "resources/textures/heightmap.png";
+const Vector3 levelSpawn = { 0, 105, 0 };
+const Vector3 levelPlayerScale = { 0.01f, 0.01f, 0.01f };
+const float levelPlayerSpeed = 10.0f;
+
+// CPU only, safe on a worker. Kept at the image's full resolution:
+// TerrainRenderer draws far ground coarser on its own.
+bool LoadLevelHeights(Terrain& terrain) {
+    Image img = LoadImage(levelHeightmap);
+    if (img.data == nullptr) return false;
+    terrain.Load(img);
+    UnloadImage(img);
+    return true;
+}
+
+// Adds the level's blocks with collision only; the game draws the ground
+// with a TerrainRenderer. terrain must outlive the world. Returns the ground's index.
+int BuildLevel(World& world, Terrain& terrain) {
+    Block ground = { {0,-0.9,0},{100,10,100} };
+    ground.layer = 0;
+    ground.color = DARKGRAY;
+    ground.name = "Ground";
+    ground.terrain = &terrain;
+    Block wall2 = { {0,0,-10},{1,2,1} };
+    Block wall3 = { {10,0,10},{1,2,1} };
+    world.AddBlock(wall2);
+    world.AddBlock(wall3);
+    world.AddBlock(ground);
+    // Cable strung between the two walls
+    world.ropes.Attach(RopeAnchor::OnBlock(0, { 0, 1, 0 }), RopeAnchor::OnBlock(1, { 0, 1, 0 }), world.blocks, { 0, 0, 0 }, 40);
+    return (int)world.blocks.size() - 1;
+}
+
+void PlaceLevelPlayer(Player& player) {
+    player.rotation = { 0,0,0 };
+    player.moveSpeed = levelPlayerSpeed;
+    player.animIndex = 0;
+}
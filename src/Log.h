@@ -0,0 +1,97 @@
+#pragma once
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Buffered, rate-limited logging. Lines collect in memory and reach stdout in
+// one write per frame. Each call site (keyed by its format string) prints at
+// most maxPerSecond lines a second; the rest are only counted, and a summary
+// line reports how many were dropped. Dropped lines are never formatted.
+class Logger {
+public:
+    int maxPerSecond = 5;
+
+    static Logger& Instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    ~Logger() {
+        std::lock_guard<std::mutex> lock(mutex);
+        FlushLocked(true);
+    }
+
+    void Write(const char* format, ...) {
+        int64_t now = NowMs();
+        std::lock_guard<std::mutex> lock(mutex);
+        Site& site = sites[format];
+        if (now - site.windowStart >= 1000) {
+            if (site.suppressed > 0) AppendSummary(site.suppressed, format);
+            site.windowStart = now;
+            site.count = 0;
+            site.suppressed = 0;
+        }
+        if (site.count >= maxPerSecond) {
+            site.suppressed++;
+            return;
+        }
+        site.count++;
+
+        va_list args;
+        va_start(args, format);
+        char line[512];
+        vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        buffer += line;
+        if (buffer.size() > flushSize) FlushLocked();
+    }
+
+    // Main thread, once per frame
+    void Flush() {
+        std::lock_guard<std::mutex> lock(mutex);
+        FlushLocked();
+    }
+
+private:
+    struct Site {
+        int64_t windowStart = -1000;
+        int count = 0;
+        int suppressed = 0;
+    };
+
+    static const size_t flushSize = 64 * 1024;
+    std::mutex mutex;
+    std::string buffer;
+    std::unordered_map<const char*, Site> sites;
+
+    static int64_t NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void AppendSummary(int suppressed, const char* format) {
+        std::string text = format;
+        while (!text.empty() && text.back() == '\n') text.pop_back();
+        buffer += "(" + std::to_string(suppressed) + " more: " + text + ")\n";
+    }
+
+    void FlushLocked(bool final = false) {
+        // Report sites that went quiet after being limited
+        int64_t now = NowMs();
+        for (auto& [format, site] : sites) {
+            if (site.suppressed > 0 && (final || now - site.windowStart >= 1000)) {
+                AppendSummary(site.suppressed, format);
+                site.suppressed = 0;
+            }
+        }
+        if (buffer.empty()) return;
+        fwrite(buffer.data(), 1, buffer.size(), stdout);
+        fflush(stdout);
+        buffer.clear();
+    }
+};
+
+#define LOG(...) Logger::Instance().Write(__VA_ARGS__)
@@ -0,0 +1,12 @@
+#version 330
+
+// Input uniform values
+uniform float maskId;   // Which outlined object this is, id / 255
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    finalColor = vec4(maskId, 0.0, 0.0, 1.0);
+}
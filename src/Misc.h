@@ -5,6 +5,8 @@
 #include <vector>
 #include <string>
 #include "rlgl.h"
+#include "Transforms.h"
+#include "Log.h"
 using namespace std;
 typedef struct BoxCollider {
 	BoundingBox collider;
@@ -12,7 +14,7 @@ typedef struct BoxCollider {
     void CheckCollision(BoxCollider& box1, BoxCollider& box2) {
 		if (CheckCollisionBoxes(box1.collider, box2.collider)) {
 			// Handle collision
-			std::cout << "Collision detected between " << box1.collider.min.x << " and " << box2.collider.min.x << std::endl;
+			LOG("Collision detected between %f and %f\n", box1.collider.min.x, box2.collider.min.x);
 		}
     }
 } Collider;
@@ -35,21 +37,9 @@ Vector3 CatmullRom(Vector3 p0, Vector3 p1, Vector3 p2, Vector3 p3, float t) {
     };
 }
 
+// Rotation is in degrees (see ComposeTransform)
 Matrix CreateTransformMatrix(Vector3 position, Vector3 rotation) {
-    // Convert degrees to radians because Raylib uses radians in matrix functions
-    float rx = DEG2RAD * rotation.x;
-    float ry = DEG2RAD * rotation.y;
-    float rz = DEG2RAD * rotation.z;
-    rlPushMatrix();
-    Matrix translation = MatrixTranslate(position.x, position.y, position.z);
-    Matrix rotX = MatrixRotateX(rx);
-    Matrix rotY = MatrixRotateY(ry);
-    Matrix rotZ = MatrixRotateZ(rz);
-
-    // Combine: M = T * Rz * Ry * Rx
-    Matrix transform = MatrixMultiply(MatrixMultiply(rotZ, MatrixMultiply(rotY, rotX)), translation);
-    rlPopMatrix();
-    return transform;
+    return ComposeTransform(position, rotation, { 1, 1, 1 });
 }
 void DrawSine(Vector3 lastPos, float dt, float speed,float amplitude,float phase_angle=1){
     for (int i = 0; i < GetScreenWidth(); i++) {
@@ -68,25 +58,6 @@ std::string Vector3ToString(Vector3 vec) {
     return "{" + std::to_string(vec.x) + ", " + std::to_string(vec.y) + ", " + std::to_string(vec.z) + "}";
 }
 
-BoundingBox GetTransformedBoundingBox(Model model, Vector3 position, Vector3 scale, bool recalculate = false) {
-	static BoundingBox cachedBoundingBox = { {0, 0, 0}, {0, 0, 0} }; // Static cache
-
-	// Only recalculate if needed
-	if (recalculate) {
-		cachedBoundingBox = GetModelBoundingBox(model);
-	}
-
-	// Apply scale and position transformations
-	Vector3 scaledMin = Vector3Multiply(cachedBoundingBox.min, scale);
-	Vector3 scaledMax = Vector3Multiply(cachedBoundingBox.max, scale);
-
-	// Move the box to the correct position
-	scaledMin = Vector3Add(scaledMin, position);
-	scaledMax = Vector3Add(scaledMax, position);
-
-	BoundingBox transformedBB = { scaledMin, scaledMax };
-	return transformedBB;
-}
 float LerpAngle(float from, float to, float t) {
 	float difference = fmodf(to - from + 540.0f, 360.0f) - 180.0f;
 	return from + difference * t;
@@ -165,20 +136,3 @@ Vector3 ScreenToWorld(Vector2 pos, Matrix view, Matrix projection) {
 	return origin;
 	
 }
-static inline float GetModelHeightFromWorld(Color* pixels, int mapWidth, int mapHeight, Vector3 pos, Vector3 size)
-{
-	// Convert world X,Z to image-space coordinates
-	int x = (int)(pos.x * (mapWidth - 1) / size.x);
-	int z = (int)(pos.z * (mapHeight - 1) / size.z);
-
-	// Clamp to valid image range
-	if (x < 0) x = 0; if (x >= mapWidth) x = mapWidth - 1;
-	if (z < 0) z = 0; if (z >= mapHeight) z = mapHeight - 1;
-
-	// Fetch grayscale from pixel
-	Color c = pixels[x + z * mapWidth];
-	float gray = (float)(c.r + c.g + c.b) / 3.0f;
-
-	// Scale to world height
-	return gray * (size.y / 255.0f);
-}
@@ -5,49 +5,19 @@ in vec2 fragTexCoord;
 in vec4 fragColor;
 
 // Input uniform values
-uniform sampler2D texture0;
+uniform sampler2D texture0;   // The scene
+uniform sampler2D bloom;      // Blurred bright parts, at a quarter of the size
 uniform vec4 colDiffuse;
-uniform vec4 neonColor;   // Neon glow color
+uniform vec4 neonColor;       // Neon glow color
 uniform float glowIntensity;  // How strong the glow is
-uniform float quality;  // Blur quality (lower = sharper, higher = smoother)
 
 // Output fragment color
 out vec4 finalColor;
 
-// Constants
-const vec2 size = vec2(1200, 800);  // Framebuffer size
-const int BLUR_RADIUS = 3;          // Constant blur radius
-const int NUM_PASSES = 3;           // How many times we blur the glow
-const float blurSpread = 1.5;       // Multiplier for each blur step
-const float edgeThreshold = 0.4;    // How much brightness is needed for a glow
-
+// Final composition of the bloom chain: keep source color, add the glow
 void main()
 {
-    vec4 sum = vec4(0.0);
-    vec2 texelSize = vec2(1.0) / size * quality;
-    
-    // Get the base color
     vec4 source = texture(texture0, fragTexCoord);
-
-    // Edge detection for neon glow (keeps only bright parts)
-    float brightness = dot(source.rgb, vec3(0.299, 0.587, 0.114)); // Luminance
-    vec4 glow = brightness > edgeThreshold ? source : vec4(0.0);  
-
-    // Blur pass to spread the glow outward
-    for (int pass = 0; pass < NUM_PASSES; pass++)
-    {
-        float radius = BLUR_RADIUS * (1.0 + pass * blurSpread);
-
-        for (int i = -BLUR_RADIUS; i <= BLUR_RADIUS; i++)
-        {
-            sum += texture(texture0, fragTexCoord + vec2(i, 0) * texelSize * radius) * 0.1;
-            sum += texture(texture0, fragTexCoord + vec2(0, i) * texelSize * radius) * 0.1;
-        }
-    }
-
-    // Apply neon color and intensity
-    vec4 neonGlow = sum * neonColor * glowIntensity;
-
-    // Final composition: keep source color, add the glow
-    finalColor = source + neonGlow * colDiffuse;
+    vec3 glow = texture(bloom, fragTexCoord).rgb * neonColor.rgb * glowIntensity;
+    finalColor = vec4(source.rgb + glow * colDiffuse.rgb, source.a);
 }
@@ -0,0 +1,34 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;   // Mask after Dilate.frag: highest id within thickness across
+uniform sampler2D mask;       // Outline mask: object id in red, 0 where there is none
+uniform vec2 resolution;      // Size of texture0 in texels
+uniform float thickness;      // Outline width in pixels
+uniform vec4 outlineColor;
+
+// Output fragment color
+out vec4 finalColor;
+
+// Edge detect on the mask: a pixel is outline when something with a higher
+// id is within thickness of it, so outlines sit outside each silhouette and
+// between two touching objects only one side draws. The vertical half of the
+// dilate happens here, one tap per texel like the horizontal one.
+void main()
+{
+    float texel = 1.0 / resolution.y;
+    int reach = max(int(thickness + 0.5), 1);
+    float id = texture(mask, fragTexCoord).r;
+    float nearest = texture(texture0, fragTexCoord).r;
+    for (int i = 1; i <= reach; i++)
+    {
+        nearest = max(nearest, texture(texture0, fragTexCoord + vec2(0.0, float(i) * texel)).r);
+        nearest = max(nearest, texture(texture0, fragTexCoord - vec2(0.0, float(i) * texel)).r);
+    }
+    float edge = nearest > id ? 1.0 : 0.0;
+    finalColor = vec4(outlineColor.rgb, outlineColor.a * edge);
+}
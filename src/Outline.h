@@ -0,0 +1,110 @@
+#pragma once
+#include "raylib.h"
+#include "rlgl.h"
+#include "RenderGraph.h"
+#include <functional>
+
+// Outlines around highlighted objects, as passes on a RenderGraph: the
+// objects are drawn flat into a mask, each with its own id, then a separable
+// dilate spreads the ids by thickness and the edge detect draws the outline
+// onto the scene where a higher id spread. Outlining costs the same however
+// many objects are highlighted. The mask is drawn without the scene's depth
+// on purpose, so the player and the grappled block stay outlined behind
+// blocks. All passes switch with the "Outline" toggle.
+class Outline {
+public:
+    float thickness = 10.0f;    // pixels
+    Vector4 color = { 0.0f, 1.0f, 0.0f, 1.0f };
+
+    // Needs the GL context
+    void Load() {
+        Unload();
+        maskShader = LoadShader("src/outline.vert", "src/Mask.frag");
+        dilateShader = LoadShader(0, "src/Dilate.frag");
+        edgeShader = LoadShader(0, "src/Outline.frag");
+        maskIdLoc = GetShaderLocation(maskShader, "maskId");
+        dilateResolutionLoc = GetShaderLocation(dilateShader, "resolution");
+        dilateThicknessLoc = GetShaderLocation(dilateShader, "thickness");
+        maskLoc = GetShaderLocation(edgeShader, "mask");
+        resolutionLoc = GetShaderLocation(edgeShader, "resolution");
+        thicknessLoc = GetShaderLocation(edgeShader, "thickness");
+        colorLoc = GetShaderLocation(edgeShader, "outlineColor");
+        maskMaterial = LoadMaterialDefault();
+        maskMaterial.shader = maskShader;
+        loaded = true;
+    }
+
+    void Unload() {
+        if (!loaded) return;
+        UnloadShader(dilateShader);
+        UnloadShader(edgeShader);
+        UnloadMaterial(maskMaterial); // and maskShader with it
+        loaded = false;
+    }
+
+    // Adds the passes, outlining onto scene. drawHighlighted runs inside the
+    // mask pass, in 3D with camera, and draws each object after SetId.
+    void AddPasses(RenderGraph& graph, int scene, Camera3D camera, std::function<void()> drawHighlighted) {
+        TargetDesc desc = graph.GetDesc(scene);
+        desc.format = PIXELFORMAT_UNCOMPRESSED_GRAYSCALE;
+        desc.filter = TEXTURE_FILTER_POINT; // ids mustn't blend into each other
+        int mask = graph.AddTarget("Outline mask", desc);
+        graph.AddPass("Outline mask", {}, mask, [camera, drawHighlighted](RenderGraph&) {
+            ClearBackground(BLANK);
+            BeginMode3D(camera);
+            drawHighlighted();
+            EndMode3D();
+        }, "Outline");
+        // One tap per texel each way: 4 * thickness + 2 fetches a pixel, and
+        // no gaps for thin or distant silhouettes to fall through
+        int spread = graph.AddTarget("Outline spread", desc);
+        graph.AddPass("Outline dilate", { mask }, spread, [this, mask, desc](RenderGraph& g) {
+            Vector2 resolution = { (float)desc.width, (float)desc.height };
+            SetShaderValue(dilateShader, dilateResolutionLoc, &resolution, SHADER_UNIFORM_VEC2);
+            SetShaderValue(dilateShader, dilateThicknessLoc, &thickness, SHADER_UNIFORM_FLOAT);
+            BeginShaderMode(dilateShader);
+            Blit(g.GetTexture(mask), desc);
+            EndShaderMode();
+        }, "Outline");
+        graph.AddPass("Outline", { spread, mask, scene }, scene, [this, spread, mask, desc](RenderGraph& g) {
+            Vector2 resolution = { (float)desc.width, (float)desc.height };
+            SetShaderValue(edgeShader, resolutionLoc, &resolution, SHADER_UNIFORM_VEC2);
+            SetShaderValue(edgeShader, thicknessLoc, &thickness, SHADER_UNIFORM_FLOAT);
+            SetShaderValue(edgeShader, colorLoc, &color, SHADER_UNIFORM_VEC4);
+            BeginShaderMode(edgeShader);
+            SetShaderValueTexture(edgeShader, maskLoc, g.GetTexture(mask));
+            Blit(g.GetTexture(spread), desc);
+            EndShaderMode();
+        }, "Outline");
+    }
+
+    // Inside drawHighlighted: what's drawn next is object id (1-255).
+    // Objects with higher ids are outlined where they touch lower ones.
+    void SetId(int id) {
+        rlDrawRenderBatchActive(); // batched shapes so far keep the last id
+        float value = id / 255.0f;
+        SetShaderValue(maskShader, maskIdLoc, &value, SHADER_UNIFORM_FLOAT);
+    }
+
+    // Flat shader for models and shapes (inside BeginShaderMode); the
+    // material draws meshes with it
+    Shader GetMaskShader() const { return maskShader; }
+    Material& GetMaskMaterial() { return maskMaterial; }
+
+private:
+    // Stretches source over the bound target; flipped like Bloom's, so the
+    // target keeps the mask's orientation and both can be sampled together
+    static void Blit(Texture2D source, const TargetDesc& dest) {
+        DrawTexturePro(source, { 0, 0, (float)source.width, (float)-source.height },
+            { 0, 0, (float)dest.width, (float)dest.height }, { 0, 0 }, 0.0f, WHITE);
+    }
+
+    Shader maskShader = { 0 };
+    Shader dilateShader = { 0 };
+    Shader edgeShader = { 0 };
+    Material maskMaterial = { 0 };
+    int maskIdLoc = -1;
+    int dilateResolutionLoc = -1, dilateThicknessLoc = -1;
+    int maskLoc = -1, resolutionLoc = -1, thicknessLoc = -1, colorLoc = -1;
+    bool loaded = false;
+};
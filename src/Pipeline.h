@@ -0,0 +1,121 @@
+#pragma once
+#include "raylib.h"
+#include "World.h"
+#include "RopeMesh.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Log.h"
+#include <atomic>
+
+// Everything drawing reads from the simulation, copied out once a frame has
+// been simulated. Blocks aren't in it: the simulation only reads them, and
+// they are only edited between frames.
+struct FrameSnapshot {
+    PlayerPose player;
+    Vector3 playerPosition = { 0, 0, 0 }; // after the frame's last step, for InputSource::EndFrame
+    RopeMesh ropes;                       // every rope's tube, already tessellated
+    int ropeCount = 0;
+    int steps = 0;                        // fixed steps the frame ran
+};
+
+// Simulates frame N+1 on a worker while the main thread draws frame N from
+// the front snapshot. Between Begin and Finish the world belongs to the job:
+// the main thread may read blocks and the broadphase but must not change
+// anything. Editing (ImGui, streaming callbacks, attaching) waits for Finish.
+class FramePipeline {
+public:
+    bool pipelined = true; // false simulates inside Begin, for comparison and debugging
+
+    explicit FramePipeline(World& world) : world(world) {}
+
+    ~FramePipeline() {
+        Finish();
+        JobSystem::Get().Wait(stubs); // queued stubs still point at us
+    }
+
+    // Copies the world into the front snapshot, for the first frame
+    void Refresh() {
+        Finish();
+        Capture(snapshots[front], 0);
+    }
+
+    // Starts simulating input into the back snapshot
+    void Begin(const InputFrame& input) {
+        Finish();
+        pending = input;
+        running = true;
+        if (!pipelined) {
+            Simulate();
+            return;
+        }
+        simulation.pending.store(1, std::memory_order_relaxed);
+        claimed.store(false, std::memory_order_release);
+        // Background, so the main thread never picks it up while waiting on
+        // skinning jobs; Finish runs it itself if no worker has started it.
+        // Any stub still queued from an earlier frame may run this one.
+        JobSystem::Get().RunBackground(stubs, [this] {
+            if (claimed.exchange(true, std::memory_order_acq_rel)) return;
+            Simulate();
+            simulation.pending.store(0, std::memory_order_release);
+        });
+    }
+
+    // Waits for the frame Begin started; its snapshot becomes Front()
+    void Finish() {
+        if (!running) return;
+        if (pipelined) {
+            PROFILE_ZONE("Wait for simulation");
+            // Only wait for a worker that is already simulating: the stub
+            // itself may sit behind streaming loads for a long time
+            if (!claimed.exchange(true, std::memory_order_acq_rel)) Simulate();
+            else JobSystem::Get().Wait(simulation);
+        }
+        running = false;
+        front = 1 - front;
+    }
+
+    bool IsRunning() const { return running; }
+    FrameSnapshot& Front() { return snapshots[front]; }
+
+    // GPU side of the rope meshes; needs the GL context
+    void Unload() {
+        Finish();
+        snapshots[0].ropes.Unload();
+        snapshots[1].ropes.Unload();
+    }
+
+private:
+    World& world;
+    FrameSnapshot snapshots[2];
+    int front = 0;
+    InputFrame pending;
+    bool running = false;
+    JobCounter stubs;       // queued background jobs, which may run any frame's simulation
+    JobCounter simulation;  // 1 while a worker runs the current frame
+    std::atomic<bool> claimed{ false };
+    bool ropeTooLong = false; // logged once
+
+    void Simulate() {
+        PROFILE_ZONE("Simulation");
+        int steps = world.RunFrame(pending);
+        Capture(snapshots[1 - front], steps);
+    }
+
+    void Capture(FrameSnapshot& snapshot, int steps) {
+        PROFILE_ZONE("Snapshot");
+        snapshot.steps = steps;
+        if (world.player != nullptr) {
+            snapshot.player = world.player->GetPose();
+            snapshot.playerPosition = world.player->position;
+        }
+        snapshot.ropes.Clear();
+        snapshot.ropeCount = 0;
+        world.ropes.ForEach([&](Rope& rope) {
+            if (snapshot.ropes.Append(rope, world.clock.alpha)) snapshot.ropeCount++;
+            else if (!ropeTooLong) {
+                LOG("A rope is too long for one rope mesh page and is not drawn\n");
+                ropeTooLong = true;
+            }
+        });
+    }
+};
@@ -0,0 +1,165 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Set to 0 to compile every PROFILE_ZONE out
+#ifndef GRAPPLE_PROFILE
+#define GRAPPLE_PROFILE 1
+#endif
+
+struct ProfileEvent {
+    const char* name; // string literal, never copied
+    int64_t start;    // ns since the profiler started
+    int64_t end;
+    int depth;        // nesting level on its thread
+};
+
+// Ring of finished zones for one thread. Only the owning thread writes; the
+// UI copies the most recent entries, which the ring is far too large to be
+// overwriting while they are read.
+struct ThreadProfile {
+    static const int capacity = 16384;
+    std::vector<ProfileEvent> events = std::vector<ProfileEvent>(capacity);
+    std::atomic<uint64_t> written{ 0 };
+    int depth = 0;
+    int id = 0;
+    std::string name;
+};
+
+// One thread's zones that ended inside a time window, oldest first
+struct ThreadEvents {
+    int id;
+    std::string name;
+    std::vector<ProfileEvent> events;
+};
+
+class Profiler {
+public:
+    static Profiler& Instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    static int64_t Now() {
+        static const auto epoch = std::chrono::steady_clock::now();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    // Registered on the first zone a thread opens
+    ThreadProfile& CurrentThread() {
+        thread_local ThreadProfile* current = nullptr;
+        if (!current) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.push_back(std::make_unique<ThreadProfile>());
+            current = threads.back().get();
+            current->id = (int)threads.size() - 1;
+            current->name = "Thread " + std::to_string(current->id);
+        }
+        return *current;
+    }
+
+    void SetThreadName(const std::string& name) {
+        ThreadProfile& thread = CurrentThread();
+        std::lock_guard<std::mutex> lock(mutex);
+        thread.name = name;
+    }
+
+    // Main thread, once at the top of every frame
+    void BeginFrame() {
+        previousFrameStart = frameStart;
+        frameStart = Now();
+    }
+
+    // Window of the last complete frame
+    int64_t GetLastFrameStart() const { return previousFrameStart; }
+    int64_t GetLastFrameEnd() const { return frameStart; }
+
+    std::vector<ThreadEvents> Collect(int64_t from, int64_t to) {
+        std::vector<ThreadEvents> result;
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const std::unique_ptr<ThreadProfile>& thread : threads) {
+            ThreadEvents copy = { thread->id, thread->name, {} };
+            uint64_t written = thread->written.load(std::memory_order_acquire);
+            uint64_t oldest = written > ThreadProfile::capacity ? written - ThreadProfile::capacity : 0;
+            // Zones are stored in the order they end, so walk back until before the window
+            for (uint64_t i = written; i > oldest; i--) {
+                const ProfileEvent& event = thread->events[(i - 1) % ThreadProfile::capacity];
+                if (event.end < from) break;
+                if (event.start >= from && event.end <= to) copy.events.push_back(event);
+            }
+            std::reverse(copy.events.begin(), copy.events.end());
+            if (!copy.events.empty()) result.push_back(std::move(copy));
+        }
+        return result;
+    }
+
+    // Everything still in the rings, in Chrome's trace event format
+    // (open in chrome://tracing or ui.perfetto.dev)
+    bool WriteChromeTrace(const char* path) {
+        FILE* file = fopen(path, "w");
+        if (!file) return false;
+        std::vector<ThreadEvents> all = Collect(0, INT64_MAX);
+        fprintf(file, "{\"traceEvents\":[\n");
+        bool first = true;
+        for (const ThreadEvents& thread : all) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", thread.id, thread.name.c_str());
+            first = false;
+            for (const ProfileEvent& event : thread.events) {
+                fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                    event.name, thread.id, event.start / 1000.0, (event.end - event.start) / 1000.0);
+            }
+        }
+        fprintf(file, "\n]}\n");
+        fclose(file);
+        return true;
+    }
+
+private:
+    std::mutex mutex; // guards the thread list and names, never taken by zones
+    std::vector<std::unique_ptr<ThreadProfile>> threads;
+    int64_t frameStart = 0;
+    int64_t previousFrameStart = 0;
+};
+
+// Times the enclosing scope. Costs two clock reads and one ring write.
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* zoneName)
+        : thread(Profiler::Instance().CurrentThread()), name(zoneName) {
+        depth = thread.depth++;
+        start = Profiler::Now();
+    }
+
+    ~ProfileZone() {
+        int64_t end = Profiler::Now();
+        thread.depth--;
+        uint64_t index = thread.written.load(std::memory_order_relaxed);
+        thread.events[index % ThreadProfile::capacity] = { name, start, end, depth };
+        thread.written.store(index + 1, std::memory_order_release);
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    ThreadProfile& thread;
+    const char* name;
+    int64_t start;
+    int depth;
+};
+
+#if GRAPPLE_PROFILE
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
@@ -0,0 +1,97 @@
+#pragma once
+#include "Profiler.h"
+#include "imgui.h"
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+// Timeline of the last frame (one lane per thread, nested zones stacked as a
+// flame graph), frame time history and per-zone totals. Drawn inside whatever
+// ImGui window is current.
+class ProfilerView {
+public:
+    bool paused = false;
+    const char* tracePath = "profile.json";
+
+    void Draw() {
+        Profiler& profiler = Profiler::Instance();
+        if (!paused) {
+            windowStart = profiler.GetLastFrameStart();
+            windowEnd = profiler.GetLastFrameEnd();
+            frameTimes[frameCursor] = (windowEnd - windowStart) / 1e6f;
+            frameCursor = (frameCursor + 1) % historySize;
+        }
+        if (!ImGui::CollapsingHeader("Profiler")) return;
+
+        ImGui::Checkbox("Pause", &paused);
+        ImGui::SameLine();
+        if (ImGui::Button("Export Chrome trace")) exportStatus = profiler.WriteChromeTrace(tracePath) ? tracePath : "export failed";
+        if (!exportStatus.empty()) {
+            ImGui::SameLine();
+            ImGui::Text("%s", exportStatus.c_str());
+        }
+        ImGui::PlotLines("Frame ms", frameTimes, historySize, frameCursor, nullptr, 0.0f, 33.3f, ImVec2(0, 40));
+        if (windowEnd <= windowStart) return;
+
+        std::vector<ThreadEvents> threads = profiler.Collect(windowStart, windowEnd);
+        ImGui::Text("Frame %.2f ms", (windowEnd - windowStart) / 1e6f);
+        DrawTimeline(threads);
+        DrawTotals(threads);
+    }
+
+private:
+    static const int historySize = 120;
+    float frameTimes[historySize] = { 0 };
+    int frameCursor = 0;
+    int64_t windowStart = 0;
+    int64_t windowEnd = 0;
+    std::string exportStatus;
+
+    static ImU32 ZoneColor(const char* name) {
+        unsigned int hash = 2166136261u;
+        for (const char* c = name; *c; c++) hash = (hash ^ (unsigned char)*c) * 16777619u;
+        return IM_COL32(80 + (hash & 0x7F), 80 + ((hash >> 8) & 0x7F), 80 + ((hash >> 16) & 0x7F), 255);
+    }
+
+    void DrawTimeline(const std::vector<ThreadEvents>& threads) {
+        const float rowHeight = 16.0f;
+        const float labelWidth = 70.0f;
+        ImDrawList* drawList = ImGui::GetWindowDrawList();
+        float width = std::max(ImGui::GetContentRegionAvail().x - labelWidth, 50.0f);
+        float scale = width / (float)(windowEnd - windowStart);
+
+        for (const ThreadEvents& thread : threads) {
+            int depth = 0;
+            for (const ProfileEvent& event : thread.events) depth = std::max(depth, event.depth + 1);
+            ImVec2 origin = ImGui::GetCursorScreenPos();
+            drawList->AddText(origin, IM_COL32(255, 255, 255, 255), thread.name.c_str());
+
+            for (const ProfileEvent& event : thread.events) {
+                ImVec2 min(origin.x + labelWidth + (event.start - windowStart) * scale, origin.y + event.depth * rowHeight);
+                ImVec2 max(std::max(origin.x + labelWidth + (event.end - windowStart) * scale, min.x + 1.0f), min.y + rowHeight - 1.0f);
+                drawList->AddRectFilled(min, max, ZoneColor(event.name));
+                if (max.x - min.x > 30.0f) drawList->AddText(ImVec2(min.x + 2.0f, min.y), IM_COL32(0, 0, 0, 255), event.name);
+                if (ImGui::IsMouseHoveringRect(min, max)) ImGui::SetTooltip("%s: %.3f ms", event.name, (event.end - event.start) / 1e6f);
+            }
+            ImGui::Dummy(ImVec2(labelWidth + width, depth * rowHeight + 2.0f));
+        }
+    }
+
+    void DrawTotals(const std::vector<ThreadEvents>& threads) {
+        struct Total { float ms = 0.0f; int calls = 0; };
+        std::map<std::string, Total> totals;
+        for (const ThreadEvents& thread : threads) {
+            for (const ProfileEvent& event : thread.events) {
+                Total& total = totals[event.name];
+                total.ms += (event.end - event.start) / 1e6f;
+                total.calls++;
+            }
+        }
+        std::vector<std::pair<std::string, Total>> sorted(totals.begin(), totals.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.second.ms > b.second.ms; });
+        for (const auto& [name, total] : sorted) {
+            ImGui::Text("%-20s %7.3f ms  x%d", name.c_str(), total.ms, total.calls);
+        }
+    }
+};
@@ -0,0 +1,259 @@
+#pragma once
+#include "raylib.h"
+#include "rlgl.h"
+#include "Profiler.h"
+#include <cstring>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// Size, format and filtering of a render target. Targets with equal
+// descriptions can share the same texture.
+struct TargetDesc {
+    int width = 0;
+    int height = 0;
+    int format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    int filter = TEXTURE_FILTER_BILINEAR;
+
+    bool operator==(const TargetDesc& other) const {
+        return width == other.width && height == other.height && format == other.format && filter == other.filter;
+    }
+
+    size_t GetBytes() const { return (size_t)width * height * (format == PIXELFORMAT_UNCOMPRESSED_GRAYSCALE ? 1 : 4); }
+
+    // What BeginMode3D projects with while this target is bound
+    float GetAspect() const { return height > 0 ? (float)width / height : 1.0f; }
+};
+
+// Render targets kept from frame to frame, handed out by description. One
+// that goes unused for a few frames (the window was resized, an effect was
+// turned off) is freed. Needs the GL context.
+class RenderTargetPool {
+public:
+    int keepFrames = 2;
+
+    void BeginFrame() {
+        frame++;
+        for (Entry& entry : entries) entry.inUse = false;
+    }
+
+    // A target nothing else has acquired this frame
+    RenderTexture2D Acquire(const TargetDesc& desc) {
+        for (Entry& entry : entries) {
+            if (!entry.inUse && entry.desc == desc) {
+                entry.inUse = true;
+                entry.lastUsed = frame;
+                return entry.target;
+            }
+        }
+        entries.push_back({ desc, Load(desc), true, frame });
+        return entries.back().target;
+    }
+
+    void Trim() {
+        for (size_t i = 0; i < entries.size();) {
+            if (frame - entries[i].lastUsed > keepFrames) {
+                UnloadRenderTexture(entries[i].target);
+                entries[i] = entries.back();
+                entries.pop_back();
+            }
+            else i++;
+        }
+    }
+
+    void Unload() {
+        for (Entry& entry : entries) UnloadRenderTexture(entry.target);
+        entries.clear();
+    }
+
+    int GetCount() const { return (int)entries.size(); }
+
+    size_t GetBytes() const {
+        size_t bytes = 0;
+        for (const Entry& entry : entries) bytes += entry.desc.GetBytes();
+        return bytes;
+    }
+
+private:
+    struct Entry {
+        TargetDesc desc;
+        RenderTexture2D target;
+        bool inUse;
+        long lastUsed;
+    };
+
+    std::vector<Entry> entries;
+    long frame = 0;
+
+    static RenderTexture2D Load(const TargetDesc& desc) {
+        RenderTexture2D target = LoadRenderTexture(desc.width, desc.height);
+        if (desc.format != target.texture.format) {
+            // LoadRenderTexture only makes RGBA8; swap in a color texture of the right format
+            rlUnloadTexture(target.texture.id);
+            target.texture.id = rlLoadTexture(nullptr, desc.width, desc.height, desc.format, 1);
+            target.texture.format = desc.format;
+            rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+        }
+        SetTextureFilter(target.texture, desc.filter);
+        return target;
+    }
+};
+
+// The frame's drawing as a list of passes, each reading some targets and
+// drawing into one (or the screen). Rebuilt every frame: Reset, add targets
+// and passes in the order they should run, Compile, then Execute between
+// BeginDrawing and EndDrawing.
+//
+// Compile drops passes that are toggled off and passes whose output nothing
+// reads, then gives each target a slot for the stretch of passes that use
+// it. A slot is reused by a later target with the same description once its
+// last reader is done, so effects share textures instead of each keeping
+// their own. Compile is plain CPU work and runs headlessly.
+class RenderGraph {
+public:
+    static const int screen = -1; // output of passes that draw to the window
+
+    using PassFunction = std::function<void(RenderGraph&)>;
+
+    struct Pass {
+        const char* name;       // string literal: the profiler keeps the pointer
+        const char* toggle;     // passes sharing a toggle are switched together; null for always on
+        std::vector<int> reads;
+        int output;
+        PassFunction execute;
+        bool run = false;       // set by Compile
+    };
+
+    struct Target {
+        const char* name;
+        TargetDesc desc;
+        int first = -1;         // passes that use it, set by Compile
+        int last = -1;
+        int slot = -1;          // -1 if no pass that runs draws into it
+    };
+
+    void Reset() {
+        passes.clear();
+        targets.clear();
+        slots.clear();
+    }
+
+    int AddTarget(const char* name, TargetDesc desc) {
+        targets.push_back({ name, desc });
+        return (int)targets.size() - 1;
+    }
+
+    // A pass that draws into output reading reads. It starts with output
+    // bound, as is; a pass that draws over all of it doesn't need to clear.
+    int AddPass(const char* name, std::vector<int> reads, int output, PassFunction execute, const char* toggle = nullptr) {
+        passes.push_back({ name, toggle, std::move(reads), output, std::move(execute) });
+        if (toggle != nullptr) FindToggle(toggle);
+        return (int)passes.size() - 1;
+    }
+
+    void Compile() {
+        for (Target& target : targets) target.first = target.last = target.slot = -1;
+        slots.clear();
+
+        // Back to front: a pass runs if it draws to the screen or into
+        // something a later pass that runs reads
+        std::vector<bool> read(targets.size(), false);
+        for (int p = (int)passes.size() - 1; p >= 0; p--) {
+            Pass& pass = passes[p];
+            bool wanted = pass.output == screen || read[pass.output];
+            pass.run = wanted && (pass.toggle == nullptr || IsEnabled(pass.toggle));
+            if (!pass.run) continue;
+            for (int t : pass.reads) read[t] = true;
+        }
+
+        // A target lives from the first pass that draws into it to the last
+        // that touches it. Reads of a target nothing draws into are left out.
+        for (int p = 0; p < (int)passes.size(); p++) {
+            const Pass& pass = passes[p];
+            if (!pass.run) continue;
+            if (pass.output != screen) {
+                Target& target = targets[pass.output];
+                if (target.first < 0) target.first = p;
+                target.last = p;
+            }
+            for (int t : pass.reads) {
+                if (targets[t].first >= 0) targets[t].last = p;
+            }
+        }
+
+        // Hand out slots in pass order, freeing each after its last use
+        std::vector<bool> slotBusy;
+        for (int p = 0; p < (int)passes.size(); p++) {
+            for (Target& target : targets) {
+                if (target.first != p) continue;
+                for (int s = 0; s < (int)slots.size() && target.slot < 0; s++) {
+                    if (!slotBusy[s] && slots[s] == target.desc) target.slot = s;
+                }
+                if (target.slot < 0) {
+                    target.slot = (int)slots.size();
+                    slots.push_back(target.desc);
+                    slotBusy.push_back(false);
+                }
+                slotBusy[target.slot] = true;
+            }
+            for (const Target& target : targets) {
+                if (target.last == p) slotBusy[target.slot] = false;
+            }
+        }
+    }
+
+    void Execute(RenderTargetPool& pool) {
+        pool.BeginFrame();
+        bound.resize(slots.size());
+        for (int s = 0; s < (int)slots.size(); s++) bound[s] = pool.Acquire(slots[s]);
+        for (Pass& pass : passes) {
+            if (!pass.run) continue;
+            PROFILE_ZONE(pass.name);
+            if (pass.output == screen) {
+                pass.execute(*this);
+                continue;
+            }
+            BeginTextureMode(bound[targets[pass.output].slot]);
+            pass.execute(*this);
+            EndTextureMode();
+        }
+        pool.Trim();
+    }
+
+    // Whether anything drew into target this frame; false for the output
+    // of a pass that was toggled off
+    bool IsAvailable(int target) const { return targets[target].slot >= 0; }
+
+    // Inside Execute: what the target holds so far
+    Texture2D GetTexture(int target) const {
+        if (!IsAvailable(target)) return Texture2D{ 0 };
+        return bound[targets[target].slot].texture;
+    }
+
+    const TargetDesc& GetDesc(int target) const { return targets[target].desc; }
+
+    bool IsEnabled(const char* toggle) { return FindToggle(toggle).second; }
+    void SetEnabled(const char* toggle, bool enabled) { FindToggle(toggle).second = enabled; }
+
+    // Every toggle added so far, kept across Reset, for a settings UI
+    std::vector<std::pair<const char*, bool>>& GetToggles() { return toggles; }
+
+    const std::vector<Pass>& GetPasses() const { return passes; }
+    const std::vector<Target>& GetTargets() const { return targets; }
+    const std::vector<TargetDesc>& GetSlots() const { return slots; }
+
+private:
+    std::vector<Pass> passes;
+    std::vector<Target> targets;
+    std::vector<TargetDesc> slots;          // one texture each, set by Compile
+    std::vector<RenderTexture2D> bound;     // slots' textures during Execute
+    std::vector<std::pair<const char*, bool>> toggles;
+
+    std::pair<const char*, bool>& FindToggle(const char* toggle) {
+        for (auto& entry : toggles) {
+            if (strcmp(entry.first, toggle) == 0) return entry;
+        }
+        toggles.push_back({ toggle, true });
+        return toggles.back();
+    }
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "Frustum.h"
+#include "Visibility.h"
+#include "Broadphase.h"
+#include "Classes.h"
+#include "Profiler.h"
+#include <vector>
+
+// Instances that share a mesh and color and go out in one DrawMeshInstanced
+struct RenderBatch {
+    const Mesh* mesh = nullptr;
+    Color color = WHITE;
+    std::vector<Matrix> transforms;
+};
+
+// Gathers visible blocks into per-mesh/per-color instance lists. Build() is
+// plain CPU work and runs headlessly; only Submit() talks to the GPU.
+class RenderQueue {
+public:
+    std::vector<RenderBatch> batches;
+    int visibleCount = 0;
+    int culledCount = 0;
+
+    // Keeps instance buffers allocated and drops batches nothing used last frame
+    void Clear() {
+        for (int i = (int)batches.size() - 1; i >= 0; i--) {
+            if (batches[i].transforms.empty()) batches.erase(batches.begin() + i);
+            else batches[i].transforms.clear();
+        }
+        visibleCount = 0;
+        culledCount = 0;
+    }
+
+    void Add(const Mesh& mesh, Color color, const Matrix& transform) {
+        for (RenderBatch& batch : batches) {
+            if (batch.mesh == &mesh && ColorEquals(batch.color, color)) {
+                batch.transforms.push_back(transform);
+                return;
+            }
+        }
+        RenderBatch batch;
+        batch.mesh = &mesh;
+        batch.color = color;
+        batch.transforms.push_back(transform);
+        batches.push_back(batch);
+    }
+
+    void Build(std::vector<Block>& blocks, const Frustum& frustum) {
+        PROFILE_ZONE("Cull blocks");
+        Clear();
+        for (Block& block : blocks) {
+            if (block.terrain != nullptr) continue; // drawn by TerrainRenderer
+            block.UpdateTransform();
+            if (!frustum.IntersectsBox(block.GetRenderBounds())) {
+                culledCount++;
+                continue;
+            }
+            Add(block.GetMesh(), block.color, block.transform);
+            visibleCount++;
+        }
+    }
+
+    // Same, but only walks the parts of the block tree the camera can see, so
+    // the cost follows the visible blocks rather than the level's size. Blocks
+    // too small on screen are dropped as well. tree holds the blocks' bounds
+    // by index, as World::broadphase does.
+    void Build(std::vector<Block>& blocks, const AABBTree& tree, const Visibility& visibility) {
+        PROFILE_ZONE("Cull blocks");
+        Clear();
+        tree.QueryVolume([&](const BoundingBox& box, bool inside) { return visibility.ClassifyBox(box, inside); },
+            [&](int index, bool inside) {
+                Block& block = blocks[index];
+                if (block.terrain != nullptr) return true; // drawn by TerrainRenderer
+                block.UpdateTransform();
+                BoundingBox bounds = block.GetRenderBounds();
+                if (!inside && !visibility.frustum.IntersectsBox(bounds)) return true;
+                if (visibility.IsTooSmall(bounds)) return true;
+                Add(block.GetMesh(), block.color, block.transform);
+                visibleCount++;
+                return true;
+            });
+        culledCount = (int)blocks.size() - visibleCount;
+    }
+
+    // One draw call per batch. The material needs a shader with an instanceTransform attribute.
+    void Submit(Material& material) {
+        PROFILE_ZONE("Draw blocks");
+        for (RenderBatch& batch : batches) {
+            if (batch.transforms.empty()) continue;
+            material.maps[MATERIAL_MAP_DIFFUSE].color = batch.color;
+            DrawMeshInstanced(*batch.mesh, material, batch.transforms.data(), (int)batch.transforms.size());
+        }
+    }
+
+private:
+    static bool ColorEquals(Color a, Color b) {
+        return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+    }
+};
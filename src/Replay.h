@@ -0,0 +1,86 @@
+#pragma once
+#include "Input.h"
+#include "Level.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// Result of stepping a recorded session headlessly
+struct ReplayReport {
+    std::vector<double> frameNs;    // simulation cost of each frame
+    std::vector<int> frameSteps;    // fixed steps each frame ran
+    std::vector<Vector3> trajectory; // player position after each frame
+    int divergedFrame = -1;         // first frame whose position differs from the recording
+    unsigned int checksum = 2166136261u; // over the trajectory's bits, equal runs give equal sums
+
+    double Percentile(double p) const {
+        if (frameNs.empty()) return 0.0;
+        std::vector<double> sorted = frameNs;
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[std::min(sorted.size() - 1, (size_t)(p * sorted.size()))];
+    }
+
+    void Print() const {
+        double total = 0.0;
+        int steps = 0;
+        for (size_t i = 0; i < frameNs.size(); i++) {
+            total += frameNs[i];
+            steps += frameSteps[i];
+        }
+        Vector3 last = trajectory.empty() ? Vector3{ 0, 0, 0 } : trajectory.back();
+        printf("Replay: %d frames, %d steps, trajectory %08x, %s\n", (int)frameNs.size(), steps, checksum,
+            divergedFrame < 0 ? "matches the recording" : "DIVERGED");
+        if (divergedFrame >= 0) printf("  first divergence at frame %d\n", divergedFrame);
+        printf("  final position %.4f %.4f %.4f\n", last.x, last.y, last.z);
+        printf("  sim us/frame   mean %.1f  p50 %.1f  p90 %.1f  p99 %.1f  max %.1f\n",
+            frameNs.empty() ? 0.0 : total / frameNs.size() / 1000.0, Percentile(0.5) / 1000.0,
+            Percentile(0.9) / 1000.0, Percentile(0.99) / 1000.0, Percentile(1.0) / 1000.0);
+    }
+
+    // One row per frame, for comparing distributions between builds
+    bool WriteCsv(const char* path) const {
+        FILE* file = fopen(path, "w");
+        if (!file) return false;
+        fprintf(file, "frame,steps,sim_ns,x,y,z\n");
+        for (size_t i = 0; i < frameNs.size(); i++) {
+            fprintf(file, "%d,%d,%.0f,%.6f,%.6f,%.6f\n", (int)i, frameSteps[i], frameNs[i],
+                trajectory[i].x, trajectory[i].y, trajectory[i].z);
+        }
+        fclose(file);
+        return true;
+    }
+};
+
+// Builds the level with a physics-only player and runs every recorded frame
+// through World::RunFrame, the same path the game loop takes
+ReplayReport RunReplay(const InputLog& log, const Terrain& heights) {
+    Terrain terrain = heights;
+    World world;
+    world.clock.stepRate = log.stepRate;
+    BuildLevel(world, terrain);
+    Player player({}, levelSpawn, levelPlayerScale);
+    PlaceLevelPlayer(player);
+    world.player = &player;
+
+    ReplayReport report;
+    report.frameNs.reserve(log.frames.size());
+    report.frameSteps.reserve(log.frames.size());
+    report.trajectory.reserve(log.frames.size());
+    for (size_t i = 0; i < log.frames.size(); i++) {
+        auto start = std::chrono::steady_clock::now();
+        int steps = world.RunFrame(log.frames[i]);
+        auto end = std::chrono::steady_clock::now();
+
+        Vector3 position = player.position;
+        report.frameNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+        report.frameSteps.push_back(steps);
+        report.trajectory.push_back(position);
+        const unsigned char* bytes = (const unsigned char*)&position;
+        for (size_t b = 0; b < sizeof(position); b++) report.checksum = (report.checksum ^ bytes[b]) * 16777619u;
+        if (report.divergedFrame < 0 && memcmp(&position, &log.frames[i].playerPosition, sizeof(position)) != 0) {
+            report.divergedFrame = (int)i;
+        }
+    }
+    return report;
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include "raylib.h"
+
+// GPU resources shared by every Block. Created on first use, so this needs a
+// GL context by then, and released once at shutdown.
+struct SharedResources {
+    Mesh unitCube = { 0 };
+    Material defaultMaterial = { 0 };
+    Material instancedMaterial = { 0 }; // default material with the instancing vertex shader
+    bool loaded = false;
+
+    static SharedResources& Instance() {
+        static SharedResources resources;
+        return resources;
+    }
+};
+
+inline SharedResources& GetSharedResources() {
+    SharedResources& resources = SharedResources::Instance();
+    if (!resources.loaded) {
+        resources.unitCube = GenMeshCube(1.0f, 1.0f, 1.0f);
+        resources.defaultMaterial = LoadMaterialDefault();
+
+        Shader instancing = LoadShader("src/instancing.vert", 0);
+        instancing.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation(instancing, "mvp");
+        instancing.locs[SHADER_LOC_VERTEX_INSTANCE_TX] = GetShaderLocationAttrib(instancing, "instanceTransform");
+        resources.instancedMaterial = LoadMaterialDefault();
+        resources.instancedMaterial.shader = instancing;
+        resources.loaded = true;
+    }
+    return resources;
+}
+
+inline void UnloadSharedResources() {
+    SharedResources& resources = SharedResources::Instance();
+    if (!resources.loaded) return;
+    UnloadMesh(resources.unitCube);
+    UnloadMaterial(resources.defaultMaterial);
+    UnloadMaterial(resources.instancedMaterial);
+    resources = SharedResources();
+}
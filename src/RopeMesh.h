@@ -0,0 +1,188 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "Classes.h"
+#include <cmath>
+#include <vector>
+
+// Which of a mesh's vboId buffers UploadMesh puts the indices in. raylib 5.5
+// moved it past the bone buffers and names it; before that it was always 6.
+#ifdef RL_DEFAULT_SHADER_ATTRIB_LOCATION_INDICES
+const int meshIndexBuffer = RL_DEFAULT_SHADER_ATTRIB_LOCATION_INDICES;
+#else
+const int meshIndexBuffer = 6;
+#endif
+
+// Every rope in the frame as tubes in a few dynamic meshes: tessellated on the
+// CPU, uploaded into buffers that are reused from frame to frame, and drawn
+// with one call per page. Indices are 16-bit, so ropes are packed into pages
+// of up to 65536 vertices. Clear() and Append() are plain CPU work and run
+// headlessly; Upload(), Draw() and Unload() need the GL context.
+class RopeMesh {
+public:
+    static const int pageVertices = 65536;
+
+    // A run of ropes drawn as one mesh; its indices count from firstVertex
+    struct Page {
+        int firstVertex = 0;
+        int firstIndex = 0;
+        int vertexCount = 0;
+        int indexCount = 0;
+    };
+
+    int sides = 8;              // vertices around the tube
+    int segmentsPerPair = 6;    // curve vertices between two rope points
+
+    std::vector<Vector3> vertices;
+    std::vector<Vector3> normals;
+    std::vector<Vector2> texcoords;     // x along the rope in world units, y around it
+    std::vector<unsigned short> indices;
+    std::vector<Page> pages;
+
+    void Clear() {
+        vertices.clear();
+        normals.clear();
+        texcoords.clear();
+        indices.clear();
+        pages.clear();
+    }
+
+    // Adds the rope's tube, radius rope.radius, starting a new page when the
+    // last one is full. A single rope of more than pageVertices vertices is
+    // left out and false is returned.
+    bool Append(Rope& rope, float alpha) {
+        rope.Tessellate(alpha, curve, segmentsPerPair);
+        int rings = (int)curve.size();
+        if (rings < 2) return true;
+        int ringSize = sides + 1; // seam vertex repeated so texcoords wrap
+        if (rings * ringSize > pageVertices) return false;
+        if (pages.empty() || pages.back().vertexCount + rings * ringSize > pageVertices) {
+            Page page;
+            page.firstVertex = (int)vertices.size();
+            page.firstIndex = (int)indices.size();
+            pages.push_back(page);
+        }
+        Page& page = pages.back();
+        int base = page.vertexCount;
+
+        ring.resize(ringSize);
+        for (int s = 0; s < ringSize; s++) {
+            float angle = 2.0f * PI * s / sides;
+            ring[s] = { cosf(angle), sinf(angle) };
+        }
+
+        // Frames are carried along the curve (parallel transport) rather than
+        // built from a fixed up vector, so the tube never twists or flips
+        Vector3 tangent = { 1, 0, 0 };
+        Vector3 normal = { 0, 1, 0 };
+        float along = 0.0f;
+        for (int k = 0; k < rings; k++) {
+            Vector3 ahead = curve[k < rings - 1 ? k + 1 : k];
+            Vector3 behind = curve[k > 0 ? k - 1 : k];
+            Vector3 direction = Vector3Subtract(ahead, behind);
+            float length = Vector3Length(direction);
+            if (length > 1e-9f) tangent = Vector3Scale(direction, 1.0f / length);
+
+            Vector3 projected = Vector3Subtract(normal, Vector3Scale(tangent, Vector3DotProduct(normal, tangent)));
+            float projectedLength = Vector3Length(projected);
+            if (k == 0 || projectedLength < 1e-4f) {
+                Vector3 helper = fabsf(tangent.y) < 0.9f ? Vector3{ 0, 1, 0 } : Vector3{ 1, 0, 0 };
+                normal = Vector3Normalize(Vector3CrossProduct(Vector3CrossProduct(tangent, helper), tangent));
+            }
+            else {
+                normal = Vector3Scale(projected, 1.0f / projectedLength);
+            }
+            Vector3 binormal = Vector3CrossProduct(tangent, normal);
+            if (k > 0) along += Vector3Distance(curve[k], curve[k - 1]);
+
+            for (int s = 0; s < ringSize; s++) {
+                Vector3 out = Vector3Add(Vector3Scale(normal, ring[s].x), Vector3Scale(binormal, ring[s].y));
+                vertices.push_back(Vector3Add(curve[k], Vector3Scale(out, rope.radius)));
+                normals.push_back(out);
+                texcoords.push_back({ along, (float)s / sides });
+            }
+        }
+
+        // Two triangles per quad, wound to face out of the tube
+        for (int k = 0; k < rings - 1; k++) {
+            for (int s = 0; s < sides; s++) {
+                unsigned short a = (unsigned short)(base + k * ringSize + s);
+                unsigned short b = (unsigned short)(a + 1);
+                unsigned short c = (unsigned short)(a + ringSize);
+                unsigned short d = (unsigned short)(c + 1);
+                indices.insert(indices.end(), { a, b, c, b, d, c });
+            }
+        }
+        page.vertexCount += rings * ringSize;
+        page.indexCount += (rings - 1) * sides * 6;
+        return true;
+    }
+
+    int GetVertexCount() const { return (int)vertices.size(); }
+    int GetTriangleCount() const { return (int)indices.size() / 3; }
+
+    // Copies this frame's geometry into the GPU buffers, one mesh per page,
+    // growing them when needed. Meshes of pages not used this frame are kept.
+    void Upload() {
+        if (meshes.size() < pages.size()) meshes.resize(pages.size());
+        for (size_t p = 0; p < pages.size(); p++) {
+            const Page& page = pages[p];
+            GpuPage& gpu = meshes[p];
+            if (page.vertexCount > gpu.capacity) Reserve(gpu, page.vertexCount + page.vertexCount / 2);
+            Mesh& mesh = gpu.mesh;
+            UpdateMeshBuffer(mesh, 0, &vertices[page.firstVertex], page.vertexCount * sizeof(Vector3), 0);
+            UpdateMeshBuffer(mesh, 1, &texcoords[page.firstVertex], page.vertexCount * sizeof(Vector2), 0);
+            UpdateMeshBuffer(mesh, 2, &normals[page.firstVertex], page.vertexCount * sizeof(Vector3), 0);
+            rlUpdateVertexBufferElements(mesh.vboId[meshIndexBuffer], &indices[page.firstIndex], page.indexCount * (int)sizeof(unsigned short), 0);
+            mesh.vertexCount = page.vertexCount;
+            mesh.triangleCount = page.indexCount / 3;
+        }
+        uploadedPages = (int)pages.size();
+    }
+
+    // What the last Upload() sent, one draw call per page
+    void Draw(const Material& material) {
+        for (int p = 0; p < uploadedPages; p++) {
+            if (meshes[p].mesh.triangleCount > 0) DrawMesh(meshes[p].mesh, material, MatrixIdentity());
+        }
+    }
+
+    void Unload() {
+        for (GpuPage& gpu : meshes) {
+            if (gpu.mesh.vaoId != 0) UnloadMesh(gpu.mesh);
+        }
+        meshes.clear();
+        uploadedPages = 0;
+    }
+
+    int GetPageCount() const { return (int)pages.size(); }
+
+private:
+    struct GpuPage {
+        Mesh mesh = { 0 };
+        int capacity = 0;       // vertices the GPU buffers hold
+    };
+
+    std::vector<Vector3> curve; // scratch for Append
+    std::vector<Vector2> ring;  // cos/sin around the tube
+    std::vector<GpuPage> meshes;
+    int uploadedPages = 0;
+
+    // Dynamic buffers sized for vertexCount vertices and the most indices a
+    // tube of that many can use (six per vertex). UnloadMesh frees the arrays.
+    static void Reserve(GpuPage& gpu, int vertexCount) {
+        vertexCount = vertexCount < pageVertices ? vertexCount : pageVertices;
+        if (gpu.mesh.vaoId != 0) UnloadMesh(gpu.mesh);
+        Mesh mesh = { 0 };
+        mesh.vertexCount = vertexCount;
+        mesh.triangleCount = vertexCount * 2;
+        mesh.vertices = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
+        mesh.texcoords = (float*)MemAlloc(vertexCount * 2 * sizeof(float));
+        mesh.normals = (float*)MemAlloc(vertexCount * 3 * sizeof(float));
+        mesh.indices = (unsigned short*)MemAlloc(vertexCount * 6 * sizeof(unsigned short));
+        UploadMesh(&mesh, true);
+        gpu.mesh = mesh;
+        gpu.capacity = vertexCount;
+    }
+};
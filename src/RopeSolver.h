@@ -0,0 +1,227 @@
+#pragma once
+#include <vector>
+#include <cmath>
+
+// SSE2 is part of the x64 baseline on both MSVC and GCC/Clang
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROPE_SIMD 1
+#else
+#define ROPE_SIMD 0
+#endif
+
+// Structure-of-arrays rope storage. The rope is always a chain, so constraint i
+// joins point i and point i + 1 and needs no index list.
+struct RopePoints {
+    std::vector<float> x, y, z;
+    std::vector<float> oldX, oldY, oldZ;
+    std::vector<float> invMass;  // 0 pins the point in place
+    std::vector<float> weightA;  // share of constraint i's correction applied to point i
+    std::vector<float> weightB;  // share applied to point i + 1
+    std::vector<float> rest;     // rest length of constraint i
+    int count = 0;
+
+    void Resize(int n) {
+        count = n;
+        x.assign(n, 0.0f); y.assign(n, 0.0f); z.assign(n, 0.0f);
+        oldX.assign(n, 0.0f); oldY.assign(n, 0.0f); oldZ.assign(n, 0.0f);
+        invMass.assign(n, 1.0f);
+        weightA.assign(n, 0.5f);
+        weightB.assign(n, 0.5f);
+        rest.assign(n, 0.0f);
+    }
+
+    // Splits constraint i at its midpoint. The new point moves like its neighbours.
+    void Subdivide(int i) {
+        auto insertMid = [i](std::vector<float>& v) { v.insert(v.begin() + i + 1, (v[i] + v[i + 1]) * 0.5f); };
+        insertMid(x); insertMid(y); insertMid(z);
+        insertMid(oldX); insertMid(oldY); insertMid(oldZ);
+        invMass.insert(invMass.begin() + i + 1, 1.0f);
+        weightA.insert(weightA.begin() + i + 1, 0.5f);
+        weightB.insert(weightB.begin() + i + 1, 0.5f);
+        rest[i] *= 0.5f;
+        rest.insert(rest.begin() + i + 1, rest[i]);
+        count++;
+    }
+
+    // Removes point i, joining constraints i - 1 and i into one
+    void Merge(int i) {
+        auto erase = [i](std::vector<float>& v) { v.erase(v.begin() + i); };
+        erase(x); erase(y); erase(z);
+        erase(oldX); erase(oldY); erase(oldZ);
+        erase(invMass); erase(weightA); erase(weightB);
+        rest[i - 1] += rest[i];
+        erase(rest);
+        count--;
+    }
+
+    // Call after changing invMass
+    void UpdateWeights() {
+        for (int i = 0; i < count - 1; i++) {
+            float sum = invMass[i] + invMass[i + 1];
+            weightA[i] = sum > 0.0f ? invMass[i] / sum : 0.0f;
+            weightB[i] = sum > 0.0f ? invMass[i + 1] / sum : 0.0f;
+        }
+    }
+};
+
+// Verlet step for points [first, count) with non-zero inverse mass. gravityStep is g * dt^2.
+inline void RopeIntegrateScalar(RopePoints& p, float gravityStep, int first = 0) {
+    for (int i = first; i < p.count; i++) {
+        if (p.invMass[i] == 0.0f) continue;
+        float vx = p.x[i] - p.oldX[i];
+        float vy = p.y[i] - p.oldY[i];
+        float vz = p.z[i] - p.oldZ[i];
+        p.oldX[i] = p.x[i]; p.oldY[i] = p.y[i]; p.oldZ[i] = p.z[i];
+        p.x[i] += vx;
+        p.y[i] += vy - gravityStep;
+        p.z[i] += vz;
+    }
+}
+
+// Relaxes constraint i = first, first + 2, ... Constraints of one parity share
+// no points, so each half-sweep is order independent. Returns the largest
+// relative stretch it corrected; constraints between two pinned points count 0.
+// Rest lengths are multiplied by restScale.
+inline float RopeSolveParityScalar(RopePoints& p, int first, float restScale) {
+    float maxError = 0.0f;
+    for (int i = first; i + 1 < p.count; i += 2) {
+        float dx = p.x[i + 1] - p.x[i];
+        float dy = p.y[i + 1] - p.y[i];
+        float dz = p.z[i + 1] - p.z[i];
+        float distSq = fmaxf(dx * dx + dy * dy + dz * dz, 1e-12f);
+        float s = 1.0f - p.rest[i] * restScale / sqrtf(distSq); // (dist - rest) / dist
+        float sa = s * p.weightA[i];
+        float sb = s * p.weightB[i];
+        maxError = fmaxf(maxError, fabsf(s) * (p.weightA[i] + p.weightB[i]));
+        p.x[i] += dx * sa; p.y[i] += dy * sa; p.z[i] += dz * sa;
+        p.x[i + 1] -= dx * sb; p.y[i + 1] -= dy * sb; p.z[i + 1] -= dz * sb;
+    }
+    return maxError;
+}
+
+inline int RopeSolveScalar(RopePoints& p, int maxIterations, float tolerance, float restScale) {
+    for (int it = 0; it < maxIterations; it++) {
+        float error = RopeSolveParityScalar(p, 0, restScale);           // red
+        error = fmaxf(error, RopeSolveParityScalar(p, 1, restScale));   // black
+        if (error < tolerance) return it + 1;
+    }
+    return maxIterations;
+}
+
+#if ROPE_SIMD
+inline __m128 RopeSelect(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+inline void RopeIntegrateSimd(RopePoints& p, float gravityStep) {
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 g = _mm_set1_ps(gravityStep);
+    int i = 0;
+    for (; i + 4 <= p.count; i += 4) {
+        __m128 movable = _mm_cmpneq_ps(_mm_loadu_ps(&p.invMass[i]), zero);
+
+        __m128 px = _mm_loadu_ps(&p.x[i]), ox = _mm_loadu_ps(&p.oldX[i]);
+        __m128 py = _mm_loadu_ps(&p.y[i]), oy = _mm_loadu_ps(&p.oldY[i]);
+        __m128 pz = _mm_loadu_ps(&p.z[i]), oz = _mm_loadu_ps(&p.oldZ[i]);
+
+        __m128 nx = _mm_sub_ps(_mm_add_ps(px, px), ox);
+        __m128 ny = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(py, py), oy), g);
+        __m128 nz = _mm_sub_ps(_mm_add_ps(pz, pz), oz);
+
+        _mm_storeu_ps(&p.oldX[i], RopeSelect(movable, px, ox));
+        _mm_storeu_ps(&p.oldY[i], RopeSelect(movable, py, oy));
+        _mm_storeu_ps(&p.oldZ[i], RopeSelect(movable, pz, oz));
+        _mm_storeu_ps(&p.x[i], RopeSelect(movable, nx, px));
+        _mm_storeu_ps(&p.y[i], RopeSelect(movable, ny, py));
+        _mm_storeu_ps(&p.z[i], RopeSelect(movable, nz, pz));
+    }
+    RopeIntegrateScalar(p, gravityStep, i);
+}
+
+// Four constraints of one parity per iteration: eight consecutive points are
+// split into even (a) and odd (b) lanes, corrected, then interleaved back.
+inline float RopeSolveParitySimd(RopePoints& p, int first, float restScale) {
+    const __m128 scale = _mm_set1_ps(restScale);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 signMask = _mm_set1_ps(-0.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 threeHalves = _mm_set1_ps(1.5f);
+    const __m128 eps = _mm_set1_ps(1e-12f);
+    __m128 maxError = _mm_setzero_ps();
+
+    int i = first;
+    for (; i + 7 < p.count; i += 8) {
+        __m128 x0 = _mm_loadu_ps(&p.x[i]), x1 = _mm_loadu_ps(&p.x[i + 4]);
+        __m128 y0 = _mm_loadu_ps(&p.y[i]), y1 = _mm_loadu_ps(&p.y[i + 4]);
+        __m128 z0 = _mm_loadu_ps(&p.z[i]), z1 = _mm_loadu_ps(&p.z[i + 4]);
+        __m128 wa0 = _mm_loadu_ps(&p.weightA[i]), wa1 = _mm_loadu_ps(&p.weightA[i + 4]);
+        __m128 wb0 = _mm_loadu_ps(&p.weightB[i]), wb1 = _mm_loadu_ps(&p.weightB[i + 4]);
+        __m128 r0 = _mm_loadu_ps(&p.rest[i]), r1 = _mm_loadu_ps(&p.rest[i + 4]);
+
+        __m128 ax = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 bx = _mm_shuffle_ps(x0, x1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 ay = _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 by = _mm_shuffle_ps(y0, y1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 az = _mm_shuffle_ps(z0, z1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 bz = _mm_shuffle_ps(z0, z1, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 wa = _mm_shuffle_ps(wa0, wa1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 wb = _mm_shuffle_ps(wb0, wb1, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 rest = _mm_mul_ps(_mm_shuffle_ps(r0, r1, _MM_SHUFFLE(2, 0, 2, 0)), scale);
+
+        __m128 dx = _mm_sub_ps(bx, ax);
+        __m128 dy = _mm_sub_ps(by, ay);
+        __m128 dz = _mm_sub_ps(bz, az);
+        __m128 distSq = _mm_max_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)), eps);
+
+        // rsqrt plus one Newton step replaces the sqrt and divide
+        __m128 inv = _mm_rsqrt_ps(distSq);
+        inv = _mm_mul_ps(inv, _mm_sub_ps(threeHalves, _mm_mul_ps(_mm_mul_ps(half, distSq), _mm_mul_ps(inv, inv))));
+        __m128 s = _mm_sub_ps(one, _mm_mul_ps(rest, inv));
+        __m128 sa = _mm_mul_ps(s, wa);
+        __m128 sb = _mm_mul_ps(s, wb);
+        maxError = _mm_max_ps(maxError, _mm_mul_ps(_mm_andnot_ps(signMask, s), _mm_add_ps(wa, wb)));
+
+        ax = _mm_add_ps(ax, _mm_mul_ps(dx, sa)); bx = _mm_sub_ps(bx, _mm_mul_ps(dx, sb));
+        ay = _mm_add_ps(ay, _mm_mul_ps(dy, sa)); by = _mm_sub_ps(by, _mm_mul_ps(dy, sb));
+        az = _mm_add_ps(az, _mm_mul_ps(dz, sa)); bz = _mm_sub_ps(bz, _mm_mul_ps(dz, sb));
+
+        _mm_storeu_ps(&p.x[i], _mm_unpacklo_ps(ax, bx)); _mm_storeu_ps(&p.x[i + 4], _mm_unpackhi_ps(ax, bx));
+        _mm_storeu_ps(&p.y[i], _mm_unpacklo_ps(ay, by)); _mm_storeu_ps(&p.y[i + 4], _mm_unpackhi_ps(ay, by));
+        _mm_storeu_ps(&p.z[i], _mm_unpacklo_ps(az, bz)); _mm_storeu_ps(&p.z[i + 4], _mm_unpackhi_ps(az, bz));
+    }
+
+    // Leftover constraints at the end of the chain
+    float error = RopeSolveParityScalar(p, i, restScale);
+    maxError = _mm_max_ps(maxError, _mm_shuffle_ps(maxError, maxError, _MM_SHUFFLE(1, 0, 3, 2)));
+    maxError = _mm_max_ps(maxError, _mm_shuffle_ps(maxError, maxError, _MM_SHUFFLE(2, 3, 0, 1)));
+    return fmaxf(error, _mm_cvtss_f32(maxError));
+}
+
+inline int RopeSolveSimd(RopePoints& p, int maxIterations, float tolerance, float restScale) {
+    for (int it = 0; it < maxIterations; it++) {
+        float error = RopeSolveParitySimd(p, 0, restScale);
+        error = fmaxf(error, RopeSolveParitySimd(p, 1, restScale));
+        if (error < tolerance) return it + 1;
+    }
+    return maxIterations;
+}
+#endif
+
+inline void RopeIntegrate(RopePoints& p, float gravityStep, bool simd = true) {
+#if ROPE_SIMD
+    if (simd) { RopeIntegrateSimd(p, gravityStep); return; }
+#endif
+    RopeIntegrateScalar(p, gravityStep);
+}
+
+// Relaxes until the largest relative stretch of a sweep is under tolerance, or
+// for maxIterations sweeps. A tolerance of 0 always runs them all. Returns the
+// number of sweeps run. A restScale above 1 stretches every segment evenly, for
+// ropes pulled tighter than their length, which otherwise never settle.
+inline int RopeSolve(RopePoints& p, int maxIterations, float tolerance = 0.0f, bool simd = true, float restScale = 1.0f) {
+#if ROPE_SIMD
+    if (simd) return RopeSolveSimd(p, maxIterations, tolerance, restScale);
+#endif
+    return RopeSolveScalar(p, maxIterations, tolerance, restScale);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "Classes.h"
+#include "Broadphase.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <deque>
+#include <vector>
+
+// What one end of a rope is tied to. Following a block or the player picks up
+// their movement every step; with neither, offset is a fixed world position.
+struct RopeAnchor {
+    int block = -1;             // index into the world's blocks
+    bool player = false;
+    Vector3 offset = { 0, 0, 0 };
+
+    static RopeAnchor AtPoint(Vector3 point) { RopeAnchor anchor; anchor.offset = point; return anchor; }
+    static RopeAnchor OnBlock(int index, Vector3 offset = { 0, 0, 0 }) { RopeAnchor anchor; anchor.block = index; anchor.offset = offset; return anchor; }
+    static RopeAnchor OnPlayer() { RopeAnchor anchor; anchor.player = true; return anchor; }
+};
+
+// Every rope in the level: grapples, cables, bridges. Ropes live in recycled
+// slots, so a detached rope's point arrays are reused by the next attach
+// instead of being freed and reallocated. Ropes don't interact, so Step
+// solves them in parallel; collision only reads the blocks and broadphase.
+class RopeWorld {
+public:
+    bool parallel = true;
+
+    // Returns a handle for Get and Detach. Rope addresses stay valid until detached.
+    int Attach(RopeAnchor start, RopeAnchor end, const std::vector<Block>& blocks, Vector3 playerPosition, int pointCount = 50) {
+        int id;
+        if (!freeSlots.empty()) {
+            id = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else {
+            id = (int)slots.size();
+            slots.emplace_back();
+        }
+        Slot& slot = slots[id];
+        slot.start = start;
+        slot.end = end;
+        slot.active = true;
+        slot.rope.startInvMass = slot.rope.endInvMass = 0.0f; // a reused slot may have had a weighted end
+        slot.rope.Init(pointCount, Resolve(start, blocks, playerPosition), Resolve(end, blocks, playerPosition));
+        activeCount++;
+        return id;
+    }
+
+    void Detach(int id) {
+        if (id < 0 || id >= (int)slots.size() || !slots[id].active) return;
+        slots[id].active = false;
+        freeSlots.push_back(id);
+        activeCount--;
+    }
+
+    Rope* Get(int id) {
+        if (id < 0 || id >= (int)slots.size() || !slots[id].active) return nullptr;
+        return &slots[id].rope;
+    }
+
+    int GetActiveCount() const { return activeCount; }
+
+    template <typename F>
+    void ForEach(F&& fn) {
+        for (Slot& slot : slots) {
+            if (slot.active) fn(slot.rope);
+        }
+    }
+
+    // One fixed step of every rope: move anchors, integrate, solve, collide
+    void Step(const std::vector<Block>& blocks, const AABBTree& broadphase, Vector3 playerPosition, float dt) {
+        active.clear();
+        for (int i = 0; i < (int)slots.size(); i++) {
+            if (slots[i].active) active.push_back(i);
+        }
+        auto stepRope = [&](int i) {
+            PROFILE_ZONE("Rope step");
+            Slot& slot = slots[active[i]];
+            slot.rope.Update(Resolve(slot.start, blocks, playerPosition), Resolve(slot.end, blocks, playerPosition), dt);
+            slot.rope.OnRopeCollision(blocks, broadphase);
+        };
+        if (parallel && active.size() > 1) JobSystem::Get().ParallelFor((int)active.size(), 1, stepRope);
+        else for (int i = 0; i < (int)active.size(); i++) stepRope(i);
+    }
+
+private:
+    struct Slot {
+        Rope rope;
+        RopeAnchor start;
+        RopeAnchor end;
+        bool active = false;
+    };
+
+    std::deque<Slot> slots;     // deque so Attach never moves existing ropes
+    std::vector<int> freeSlots;
+    std::vector<int> active;    // scratch for Step
+    int activeCount = 0;
+
+    static Vector3 Resolve(const RopeAnchor& anchor, const std::vector<Block>& blocks, Vector3 playerPosition) {
+        if (anchor.player) return Vector3Add(playerPosition, anchor.offset);
+        if (anchor.block >= 0 && anchor.block < (int)blocks.size()) return Vector3Add(blocks[anchor.block].position, anchor.offset);
+        return anchor.offset;
+    }
+};
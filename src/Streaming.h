@@ -0,0 +1,72 @@
+#pragma once
+#include "JobSystem.h"
+#include "Profiler.h"
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <functional>
+
+// Two-step loads: work runs on a worker thread (file reads, parsing, mesh
+// generation), upload runs on the main thread once work is done (anything
+// that touches the GL context). Update() runs finished uploads in request
+// order until the frame's budget is spent, so one frame never stalls on a
+// whole level's worth of uploads.
+class AssetStreamer {
+public:
+    float uploadBudget = 0.004f; // seconds per frame, at least one upload always runs
+
+    ~AssetStreamer() {
+        JobSystem::Get().Wait(jobs);
+    }
+
+    void Load(std::function<void()> work, std::function<void()> upload) {
+        std::shared_ptr<Request> request = std::make_shared<Request>();
+        request->upload = std::move(upload);
+        JobSystem::Get().RunBackground(jobs, [request, work = std::move(work)] {
+            work();
+            request->ready.store(true, std::memory_order_release);
+        });
+        requests.push_back(request);
+    }
+
+    // Main thread, once per frame. Returns the number of uploads done.
+    int Update() {
+        PROFILE_ZONE("Streaming");
+        auto start = std::chrono::steady_clock::now();
+        int uploaded = 0;
+        for (auto it = requests.begin(); it != requests.end();) {
+            std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - start;
+            if (uploaded > 0 && elapsed.count() >= uploadBudget) break;
+            if (!(*it)->ready.load(std::memory_order_acquire)) {
+                ++it;
+                continue;
+            }
+            (*it)->upload();
+            it = requests.erase(it);
+            uploaded++;
+        }
+        return uploaded;
+    }
+
+    // Blocks until every request is loaded and uploaded (shutdown, level switches)
+    void Flush() {
+        while (!requests.empty()) {
+            JobSystem::Get().Wait(jobs);
+            std::deque<std::shared_ptr<Request>> batch;
+            batch.swap(requests); // uploads may queue follow-up requests
+            for (std::shared_ptr<Request>& request : batch) request->upload();
+        }
+    }
+
+    int GetPendingCount() const { return (int)requests.size(); }
+    bool IsIdle() const { return requests.empty(); }
+
+private:
+    struct Request {
+        std::function<void()> upload;
+        std::atomic<bool> ready{ false };
+    };
+
+    std::deque<std::shared_ptr<Request>> requests;
+    JobCounter jobs;
+};
@@ -0,0 +1,218 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include <vector>
+#include <cmath>
+#include <cfloat>
+
+// Height field kept on the CPU for collision. Samples follow GenMeshHeightmap's
+// layout and triangle split, as TerrainRenderer's full-resolution chunks do,
+// so queries match the rendered ground exactly without touching a mesh.
+class Terrain {
+public:
+    std::vector<float> heights; // 0..1 per sample, row-major in z
+    int width = 0;
+    int depth = 0;
+    Vector3 origin = { 0, 0, 0 }; // world position of sample (0, 0)
+    Vector3 size = { 1, 1, 1 };
+    float minHeight = 0.0f;
+    float maxHeight = 0.0f;
+
+    // Same gray value GenMeshHeightmap uses for vertex height
+    void Load(Image image) {
+        Color* pixels = LoadImageColors(image);
+        std::vector<float> samples(image.width * image.height);
+        for (int i = 0; i < samples.size(); i++) {
+            samples[i] = (float)(pixels[i].r + pixels[i].g + pixels[i].b) / 3.0f / 255.0f;
+        }
+        UnloadImageColors(pixels);
+        LoadHeights(samples, image.width, image.height);
+    }
+
+    void LoadHeights(const std::vector<float>& samples, int w, int d) {
+        heights = samples;
+        width = w;
+        depth = d;
+        minHeight = FLT_MAX;
+        maxHeight = -FLT_MAX;
+        for (float h : heights) {
+            minHeight = fminf(minHeight, h);
+            maxHeight = fmaxf(maxHeight, h);
+        }
+    }
+
+    void Place(Vector3 worldOrigin, Vector3 worldSize) {
+        origin = worldOrigin;
+        size = worldSize;
+    }
+
+    float CellX() const { return size.x / (width - 1); }
+    float CellZ() const { return size.z / (depth - 1); }
+
+    bool Contains(float x, float z) const {
+        return x >= origin.x && x <= origin.x + size.x && z >= origin.z && z <= origin.z + size.z;
+    }
+
+    BoundingBox GetBounds() const {
+        return {
+            { origin.x, origin.y + minHeight * size.y, origin.z },
+            { origin.x + size.x, origin.y + maxHeight * size.y, origin.z + size.z }
+        };
+    }
+
+    // World height at x/z, clamped to the edge outside the terrain
+    float GetHeight(float x, float z) const {
+        int ix, iz;
+        float tx, tz;
+        Locate(x, z, ix, iz, tx, tz);
+        float h00 = Sample(ix, iz), h10 = Sample(ix + 1, iz);
+        float h01 = Sample(ix, iz + 1), h11 = Sample(ix + 1, iz + 1);
+
+        float h;
+        if (tx + tz <= 1.0f) h = h00 + tx * (h10 - h00) + tz * (h01 - h00);
+        else h = h11 + (1.0f - tx) * (h01 - h11) + (1.0f - tz) * (h10 - h11);
+        return origin.y + h * size.y;
+    }
+
+    // Normal of the triangle under x/z
+    Vector3 GetNormal(float x, float z) const {
+        int ix, iz;
+        float tx, tz;
+        Locate(x, z, ix, iz, tx, tz);
+        float h00 = Sample(ix, iz), h10 = Sample(ix + 1, iz);
+        float h01 = Sample(ix, iz + 1), h11 = Sample(ix + 1, iz + 1);
+
+        float slopeX, slopeZ;
+        if (tx + tz <= 1.0f) { slopeX = h10 - h00; slopeZ = h01 - h00; }
+        else { slopeX = h11 - h01; slopeZ = h11 - h10; }
+
+        float cx = CellX(), cz = CellZ();
+        Vector3 n = { -cz * slopeX * size.y, cx * cz, -cx * slopeZ * size.y };
+        return Vector3Normalize(n);
+    }
+
+    // Walks the cells under the ray (2D DDA) and only tests triangles in cells
+    // whose height range the ray passes through
+    RayCollision Raycast(Ray ray, float maxDistance = FLT_MAX) const {
+        RayCollision result = { 0 };
+        result.distance = FLT_MAX;
+        if (width < 2 || depth < 2) return result;
+
+        float tEnter, tExit;
+        if (!ClipToBounds(ray, tEnter, tExit)) return result;
+        tExit = fminf(tExit, maxDistance);
+        if (tEnter > tExit) return result;
+
+        float cx = CellX(), cz = CellZ();
+        Vector3 start = Vector3Add(ray.position, Vector3Scale(ray.direction, tEnter));
+        int ix = ClampCell((int)floorf((start.x - origin.x) / cx), width);
+        int iz = ClampCell((int)floorf((start.z - origin.z) / cz), depth);
+
+        int stepX = ray.direction.x > 0.0f ? 1 : -1;
+        int stepZ = ray.direction.z > 0.0f ? 1 : -1;
+        float tDeltaX = ray.direction.x != 0.0f ? fabsf(cx / ray.direction.x) : FLT_MAX;
+        float tDeltaZ = ray.direction.z != 0.0f ? fabsf(cz / ray.direction.z) : FLT_MAX;
+        float tMaxX = ray.direction.x != 0.0f ? (origin.x + (ix + (stepX > 0 ? 1 : 0)) * cx - ray.position.x) / ray.direction.x : FLT_MAX;
+        float tMaxZ = ray.direction.z != 0.0f ? (origin.z + (iz + (stepZ > 0 ? 1 : 0)) * cz - ray.position.z) / ray.direction.z : FLT_MAX;
+
+        float t = tEnter;
+        while (t <= tExit) {
+            float tCellExit = fminf(fminf(tMaxX, tMaxZ), tExit);
+
+            float y0 = ray.position.y + ray.direction.y * t;
+            float y1 = ray.position.y + ray.direction.y * tCellExit;
+            float h00 = Sample(ix, iz), h10 = Sample(ix + 1, iz);
+            float h01 = Sample(ix, iz + 1), h11 = Sample(ix + 1, iz + 1);
+            float cellMin = origin.y + fminf(fminf(h00, h10), fminf(h01, h11)) * size.y;
+            float cellMax = origin.y + fmaxf(fmaxf(h00, h10), fmaxf(h01, h11)) * size.y;
+
+            if (fminf(y0, y1) <= cellMax && fmaxf(y0, y1) >= cellMin) {
+                Vector3 v00 = Vertex(ix, iz, h00), v10 = Vertex(ix + 1, iz, h10);
+                Vector3 v01 = Vertex(ix, iz + 1, h01), v11 = Vertex(ix + 1, iz + 1, h11);
+                RayTriangle(ray, v00, v01, v10, result);
+                RayTriangle(ray, v10, v01, v11, result);
+                if (result.hit && result.distance <= maxDistance) return result;
+                result.hit = false;
+            }
+
+            if (tMaxX < tMaxZ) {
+                ix += stepX;
+                t = tMaxX;
+                tMaxX += tDeltaX;
+            }
+            else {
+                iz += stepZ;
+                t = tMaxZ;
+                tMaxZ += tDeltaZ;
+            }
+            if (ix < 0 || ix > width - 2 || iz < 0 || iz > depth - 2) break;
+        }
+        return result;
+    }
+
+    // Moller-Trumbore, keeps the closest hit in result
+    static void RayTriangle(Ray ray, Vector3 a, Vector3 b, Vector3 c, RayCollision& result) {
+        Vector3 e1 = Vector3Subtract(b, a);
+        Vector3 e2 = Vector3Subtract(c, a);
+        Vector3 p = Vector3CrossProduct(ray.direction, e2);
+        float det = Vector3DotProduct(e1, p);
+        if (fabsf(det) < 1e-8f) return;
+
+        float invDet = 1.0f / det;
+        Vector3 s = Vector3Subtract(ray.position, a);
+        float u = Vector3DotProduct(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return;
+        Vector3 q = Vector3CrossProduct(s, e1);
+        float v = Vector3DotProduct(ray.direction, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return;
+
+        float t = Vector3DotProduct(e2, q) * invDet;
+        if (t < 0.0f || t >= result.distance) return;
+        result.hit = true;
+        result.distance = t;
+        result.point = Vector3Add(ray.position, Vector3Scale(ray.direction, t));
+        result.normal = Vector3Normalize(Vector3CrossProduct(e1, e2));
+    }
+
+private:
+    float Sample(int x, int z) const { return heights[x + z * width]; }
+
+    Vector3 Vertex(int x, int z, float h) const {
+        return { origin.x + x * CellX(), origin.y + h * size.y, origin.z + z * CellZ() };
+    }
+
+    static int ClampCell(int i, int samples) {
+        return i < 0 ? 0 : (i > samples - 2 ? samples - 2 : i);
+    }
+
+    // Cell index and position inside that cell for a world x/z
+    void Locate(float x, float z, int& ix, int& iz, float& tx, float& tz) const {
+        float fx = Clamp((x - origin.x) / CellX(), 0.0f, (float)(width - 1));
+        float fz = Clamp((z - origin.z) / CellZ(), 0.0f, (float)(depth - 1));
+        ix = ClampCell((int)fx, width);
+        iz = ClampCell((int)fz, depth);
+        tx = fx - ix;
+        tz = fz - iz;
+    }
+
+    bool ClipToBounds(Ray ray, float& tEnter, float& tExit) const {
+        BoundingBox box = GetBounds();
+        tEnter = 0.0f;
+        tExit = FLT_MAX;
+        const float* o = &ray.position.x;
+        const float* d = &ray.direction.x;
+        const float* lo = &box.min.x;
+        const float* hi = &box.max.x;
+        for (int axis = 0; axis < 3; axis++) {
+            if (fabsf(d[axis]) < 1e-12f) {
+                if (o[axis] < lo[axis] || o[axis] > hi[axis]) return false;
+                continue;
+            }
+            float t1 = (lo[axis] - o[axis]) / d[axis];
+            float t2 = (hi[axis] - o[axis]) / d[axis];
+            tEnter = fmaxf(tEnter, fminf(t1, t2));
+            tExit = fminf(tExit, fmaxf(t1, t2));
+        }
+        return tEnter <= tExit;
+    }
+};
@@ -0,0 +1,461 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "Terrain.h"
+#include "Visibility.h"
+#include "Streaming.h"
+#include "Profiler.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// The samples one chunk mesh is made from, copied out of the terrain on the
+// main thread so a worker can build the mesh while the terrain changes
+struct ChunkSamples {
+    std::vector<int> columns;   // terrain sample x of each vertex column, with one more on each side for normals
+    std::vector<int> rows;      // same for z
+    std::vector<float> heights; // columns.size() x rows.size(), row-major in z
+    Vector3 origin = { 0, 0, 0 }; // the terrain's placement and sample counts
+    Vector3 size = { 1, 1, 1 };
+    int width = 0;
+    int depth = 0;
+    float skirtDepth = 0.0f;    // world units the edges hang down by
+};
+
+// CPU side of a chunk mesh: indexed, in world space
+struct ChunkGeometry {
+    std::vector<float> vertices;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    std::vector<unsigned short> indices;
+
+    int GetVertexCount() const { return (int)vertices.size() / 3; }
+    int GetTriangleCount() const { return (int)indices.size() / 3; }
+};
+
+// Grid of the samples with Terrain's triangle split, so at full resolution
+// the mesh is exactly what collision sees. Smooth normals come from the
+// neighbouring samples, also across the chunk's edges. Each edge gets a
+// skirt hanging below it that hides cracks against a neighbour drawn at
+// another resolution. Plain CPU work, safe on a worker.
+ChunkGeometry BuildChunkGeometry(const ChunkSamples& samples) {
+    ChunkGeometry geometry;
+    int stride = (int)samples.columns.size();
+    int nx = stride - 2, nz = (int)samples.rows.size() - 2;
+    if (nx < 2 || nz < 2 || samples.width < 2 || samples.depth < 2) return geometry;
+
+    float cellX = samples.size.x / (samples.width - 1), cellZ = samples.size.z / (samples.depth - 1);
+    auto height = [&](int i, int j) { return samples.heights[i + j * stride]; };
+    auto emit = [&](Vector3 position, Vector3 normal, float u, float v) {
+        geometry.vertices.insert(geometry.vertices.end(), { position.x, position.y, position.z });
+        geometry.normals.insert(geometry.normals.end(), { normal.x, normal.y, normal.z });
+        geometry.texcoords.insert(geometry.texcoords.end(), { u, v });
+    };
+    auto triangle = [&](int a, int b, int c) {
+        geometry.indices.insert(geometry.indices.end(), { (unsigned short)a, (unsigned short)b, (unsigned short)c });
+    };
+
+    // Columns and rows 1..n are vertices, 0 and n + 1 only feed the normals
+    for (int j = 1; j <= nz; j++) {
+        for (int i = 1; i <= nx; i++) {
+            int x = samples.columns[i], z = samples.rows[j];
+            // The border sample is clamped at the terrain's edge, so the span can shrink to one side
+            float spanX = (samples.columns[i + 1] - samples.columns[i - 1]) * cellX;
+            float spanZ = (samples.rows[j + 1] - samples.rows[j - 1]) * cellZ;
+            float slopeX = spanX > 0.0f ? (height(i + 1, j) - height(i - 1, j)) * samples.size.y / spanX : 0.0f;
+            float slopeZ = spanZ > 0.0f ? (height(i, j + 1) - height(i, j - 1)) * samples.size.y / spanZ : 0.0f;
+            Vector3 position = { samples.origin.x + x * cellX, samples.origin.y + height(i, j) * samples.size.y, samples.origin.z + z * cellZ };
+            emit(position, Vector3Normalize({ -slopeX, 1.0f, -slopeZ }), (float)x / (samples.width - 1), (float)z / (samples.depth - 1));
+        }
+    }
+    for (int j = 0; j < nz - 1; j++) {
+        for (int i = 0; i < nx - 1; i++) {
+            int v00 = i + j * nx, v10 = v00 + 1, v01 = v00 + nx, v11 = v01 + 1;
+            triangle(v00, v01, v10);
+            triangle(v10, v01, v11);
+        }
+    }
+
+    // Edges are walked along +x or +z; flip turns the skirt to face outwards
+    auto skirt = [&](int first, int step, int count, bool flip) {
+        int bottom = geometry.GetVertexCount();
+        for (int k = 0; k < count; k++) {
+            int top = first + k * step;
+            Vector3 position = { geometry.vertices[top * 3], geometry.vertices[top * 3 + 1] - samples.skirtDepth, geometry.vertices[top * 3 + 2] };
+            Vector3 normal = { geometry.normals[top * 3], geometry.normals[top * 3 + 1], geometry.normals[top * 3 + 2] };
+            emit(position, normal, geometry.texcoords[top * 2], geometry.texcoords[top * 2 + 1]);
+        }
+        for (int k = 0; k < count - 1; k++) {
+            int t0 = first + k * step, t1 = t0 + step, b0 = bottom + k, b1 = b0 + 1;
+            if (flip) {
+                triangle(t0, b0, t1);
+                triangle(t1, b0, b1);
+            }
+            else {
+                triangle(t0, t1, b0);
+                triangle(t1, b1, b0);
+            }
+        }
+    };
+    skirt(0, 1, nx, false);                 // z min
+    skirt((nz - 1) * nx, 1, nx, true);      // z max
+    skirt(0, nx, nz, true);                 // x min
+    skirt(nx - 1, nx, nz, false);           // x max
+    return geometry;
+}
+
+// Quadtree of square chunks over a terrain. Every chunk's mesh is chunkCells
+// cells across; a chunk at level L takes every 2^L-th sample, so the
+// root covers the whole map coarsely and the leaves are full resolution.
+// Select walks it from the root each frame, splitting chunks the eye is near.
+// Plain CPU work and runs headlessly; TerrainRenderer holds the meshes.
+class TerrainQuadtree {
+public:
+    int chunkCells = 64;        // cells per chunk side; (chunkCells + 1)^2 plus skirts must fit 16-bit indices
+    float lodDistance = 2.0f;   // split a chunk when the eye is within this many of its widths
+
+    struct Node {
+        int x0, z0;             // first cell
+        int level;              // samples are 1 << level apart
+        int children[4] = { -1, -1, -1, -1 };
+        float minHeight, maxHeight; // 0..1, of every sample under the chunk
+    };
+
+    // terrain must outlive the tree. Only reads the heights, so it can run on
+    // a worker and the terrain can be placed anywhere afterwards.
+    void Build(const Terrain& source) {
+        terrain = &source;
+        nodes.clear();
+        levels = 0;
+        int cellsX = source.width - 1, cellsZ = source.depth - 1;
+        if (cellsX < 1 || cellsZ < 1) return;
+        while ((chunkCells << levels) < cellsX || (chunkCells << levels) < cellsZ) levels++;
+        levels++;
+        AddNode(0, 0, levels - 1);
+    }
+
+    // After the terrain the tree was built from was moved or copied into source
+    void SetTerrain(const Terrain& source) { terrain = &source; }
+
+    // Children go wherever the eye is within lodDistance chunk widths, but
+    // only once isReady(child) says all the visible ones can be drawn;
+    // otherwise the parent is drawn and request(child) is called for the
+    // missing ones. So the visible terrain never has holes while chunks
+    // stream in. Chunks to draw go to selected.
+    template <typename R, typename Q>
+    void Select(const Visibility& visibility, std::vector<int>& selected, R&& isReady, Q&& request) const {
+        selected.clear();
+        if (nodes.empty()) return;
+        int inside = visibility.ClassifyBox(GetBounds(nodes[0]), false);
+        if (inside >= 0) SelectNode(0, inside > 0, visibility, selected, isReady, request);
+    }
+
+    // Copy of the samples node's mesh is built from; main thread
+    ChunkSamples GetSamples(int index) const {
+        const Node& node = nodes[index];
+        int step = 1 << node.level;
+        int cellsX = terrain->width - 1, cellsZ = terrain->depth - 1;
+        ChunkSamples samples;
+        samples.origin = terrain->origin;
+        samples.size = terrain->size;
+        samples.width = terrain->width;
+        samples.depth = terrain->depth;
+        samples.skirtDepth = GetSkirtDepth(node);
+        AddRange(samples.columns, node.x0, GetSpan(node), step, cellsX);
+        AddRange(samples.rows, node.z0, GetSpan(node), step, cellsZ);
+        samples.heights.reserve(samples.columns.size() * samples.rows.size());
+        for (int z : samples.rows) {
+            for (int x : samples.columns) samples.heights.push_back(terrain->heights[x + z * terrain->width]);
+        }
+        return samples;
+    }
+
+    int GetSpan(const Node& node) const { return chunkCells << node.level; } // cells, before clipping to the map
+
+    // Cracks against a neighbour are never deeper than the heights along the shared edge span
+    float GetSkirtDepth(const Node& node) const { return fmaxf(node.maxHeight - node.minHeight, 0.001f) * terrain->size.y; }
+
+    // World box where the terrain is placed now, skirt included
+    BoundingBox GetBounds(const Node& node) const {
+        int cellsX = terrain->width - 1, cellsZ = terrain->depth - 1;
+        int x1 = node.x0 + GetSpan(node) < cellsX ? node.x0 + GetSpan(node) : cellsX;
+        int z1 = node.z0 + GetSpan(node) < cellsZ ? node.z0 + GetSpan(node) : cellsZ;
+        Vector3 origin = terrain->origin, size = terrain->size;
+        float cellX = terrain->CellX(), cellZ = terrain->CellZ();
+        return {
+            { origin.x + node.x0 * cellX, origin.y + node.minHeight * size.y - GetSkirtDepth(node), origin.z + node.z0 * cellZ },
+            { origin.x + x1 * cellX, origin.y + node.maxHeight * size.y, origin.z + z1 * cellZ }
+        };
+    }
+    int GetLevelCount() const { return levels; }
+    const std::vector<Node>& GetNodes() const { return nodes; }
+    const Terrain* GetTerrain() const { return terrain; }
+
+private:
+    const Terrain* terrain = nullptr;
+    std::vector<Node> nodes;
+    int levels = 0;
+
+    // Sample indices from first to first + span every step, clipped to the
+    // last sample, with a border sample on each side
+    static void AddRange(std::vector<int>& range, int first, int span, int step, int last) {
+        int end = first + span < last ? first + span : last;
+        range.push_back(first - step > 0 ? first - step : 0);
+        for (int i = first; i < end; i += step) range.push_back(i);
+        range.push_back(end);
+        range.push_back(end + step < last ? end + step : last);
+    }
+
+    // Bounds come from every sample under the chunk, not just the ones its
+    // mesh uses, so a parent's box holds all of its children
+    int AddNode(int x0, int z0, int level) {
+        int index = (int)nodes.size();
+        nodes.push_back({ x0, z0, level });
+        float low = FLT_MAX, high = -FLT_MAX;
+        int cellsX = terrain->width - 1, cellsZ = terrain->depth - 1;
+        int span = chunkCells << level;
+        int x1 = x0 + span < cellsX ? x0 + span : cellsX;
+        int z1 = z0 + span < cellsZ ? z0 + span : cellsZ;
+
+        if (level == 0) {
+            for (int z = z0; z <= z1; z++) {
+                for (int x = x0; x <= x1; x++) {
+                    float h = terrain->heights[x + z * terrain->width];
+                    low = fminf(low, h);
+                    high = fmaxf(high, h);
+                }
+            }
+        }
+        else {
+            int half = span / 2;
+            for (int c = 0; c < 4; c++) {
+                int cx = x0 + (c & 1) * half, cz = z0 + (c >> 1) * half;
+                if (cx >= cellsX || cz >= cellsZ) continue;
+                int child = AddNode(cx, cz, level - 1);
+                nodes[index].children[c] = child;
+                low = fminf(low, nodes[child].minHeight);
+                high = fmaxf(high, nodes[child].maxHeight);
+            }
+        }
+
+        nodes[index].minHeight = low;
+        nodes[index].maxHeight = high;
+        return index;
+    }
+
+    bool WantsSplit(const Node& node, const BoundingBox& bounds, Vector3 eye) const {
+        if (node.level == 0) return false;
+        float width = GetSpan(node) * fmaxf(terrain->CellX(), terrain->CellZ());
+        Vector3 nearest = Vector3Clamp(eye, bounds.min, bounds.max);
+        return Vector3DistanceSqr(nearest, eye) < lodDistance * lodDistance * width * width;
+    }
+
+    template <typename R, typename Q>
+    void SelectNode(int index, bool inside, const Visibility& visibility, std::vector<int>& selected, R& isReady, Q& request) const {
+        const Node& node = nodes[index];
+        if (WantsSplit(node, GetBounds(node), visibility.GetEye())) {
+            int classes[4] = { -1, -1, -1, -1 };
+            bool ready = true;
+            for (int c = 0; c < 4; c++) {
+                int child = node.children[c];
+                if (child < 0) continue;
+                classes[c] = visibility.ClassifyBox(GetBounds(nodes[child]), inside);
+                if (classes[c] < 0 || isReady(child)) continue;
+                request(child);
+                ready = false;
+            }
+            if (ready) {
+                for (int c = 0; c < 4; c++) {
+                    if (classes[c] >= 0) SelectNode(node.children[c], classes[c] > 0, visibility, selected, isReady, request);
+                }
+                return;
+            }
+        }
+        selected.push_back(index);
+    }
+};
+
+// The slow half of TerrainRenderer::Build: the quadtree and the root chunk's
+// mesh for the terrain as placed now. Plain CPU work, so it can run on a
+// worker; TerrainRenderer::Install then only uploads the root.
+struct TerrainBuild {
+    TerrainQuadtree quadtree;   // chunk size and LOD distance are set before Prepare
+    ChunkGeometry root;
+    Vector3 origin = { 0, 0, 0 }; // placement the root was built for
+    Vector3 size = { 0, 0, 0 };
+
+    void Prepare(const Terrain& terrain) {
+        PROFILE_ZONE("Build terrain chunks");
+        quadtree.Build(terrain);
+        origin = terrain.origin;
+        size = terrain.size;
+        root = quadtree.GetNodes().empty() ? ChunkGeometry{} : BuildChunkGeometry(quadtree.GetSamples(0));
+    }
+};
+
+// Draws a Terrain as TerrainQuadtree chunks. The root's mesh is built when
+// the terrain is, so there is always something to draw; finer chunks are
+// built on workers through the AssetStreamer as the eye comes near, and freed
+// once nothing has asked for them for keepFrames frames. Needs the GL context.
+class TerrainRenderer {
+public:
+    TerrainQuadtree quadtree;   // chunk size and LOD distance
+    int keepFrames = 120;
+    int maxLoads = 8;           // chunk builds in flight at once
+
+    int drawnCount = 0;         // chunks and triangles Draw submits, set by Update
+    int drawnTriangles = 0;
+
+    // Call again whenever the terrain's heights change. terrain must outlive
+    // the renderer. Takes tens of milliseconds on a big map; see NewBuild.
+    void Build(const Terrain& terrain) {
+        TerrainBuild build = NewBuild();
+        build.Prepare(terrain);
+        Install(build, terrain);
+    }
+
+    // Build split in two: Prepare the returned build on a worker, then
+    // Install it on the main thread
+    TerrainBuild NewBuild() const {
+        TerrainBuild build;
+        build.quadtree.chunkCells = quadtree.chunkCells;
+        build.quadtree.lodDistance = quadtree.lodDistance;
+        return build;
+    }
+
+    // terrain is the one build was prepared from, or where it has been moved
+    // since; it must outlive the renderer
+    void Install(TerrainBuild& build, const Terrain& terrain) {
+        PROFILE_ZONE("Install terrain chunks");
+        Unload();
+        quadtree = std::move(build.quadtree);
+        quadtree.SetTerrain(terrain);
+        chunks.assign(quadtree.GetNodes().size(), Chunk{});
+        placedOrigin = build.origin; // if the ground moved meanwhile, Update remeshes
+        placedSize = build.size;
+        if (!chunks.empty()) Upload(0, build.root);
+    }
+
+    // Main thread, once per frame before drawing: picks the chunks to draw
+    // and queues the builds of the ones missing
+    void Update(const Visibility& visibility, AssetStreamer& streamer) {
+        PROFILE_ZONE("Terrain LOD");
+        const Terrain* terrain = quadtree.GetTerrain();
+        if (terrain == nullptr) return;
+        if (!Vector3Equals(terrain->origin, placedOrigin) || !Vector3Equals(terrain->size, placedSize)) Remesh();
+        frame++;
+        quadtree.Select(visibility, selected,
+            [this](int index) {
+                chunks[index].lastUsed = frame;
+                return chunks[index].ready;
+            },
+            [this, &streamer](int index) { Request(index, streamer); });
+
+        drawnCount = (int)selected.size();
+        drawnTriangles = 0;
+        for (int index : selected) {
+            chunks[index].lastUsed = frame;
+            drawnTriangles += chunks[index].mesh.triangleCount;
+        }
+        for (int i = 1; i < (int)chunks.size(); i++) {
+            if (chunks[i].ready && frame - chunks[i].lastUsed > keepFrames) {
+                UnloadMesh(chunks[i].mesh);
+                chunks[i] = Chunk{};
+            }
+        }
+    }
+
+    void Draw(const Material& material) {
+        PROFILE_ZONE("Draw terrain");
+        for (int index : selected) DrawMesh(chunks[index].mesh, material, MatrixIdentity());
+    }
+
+    void Unload() {
+        ReleaseMeshes();
+        chunks.clear();
+        selected.clear();
+    }
+
+    int GetResidentCount() const {
+        int count = 0;
+        for (const Chunk& chunk : chunks) count += chunk.ready ? 1 : 0;
+        return count;
+    }
+
+    int GetChunkCount() const { return (int)chunks.size(); }
+
+private:
+    struct Chunk {
+        Mesh mesh = { 0 };
+        bool ready = false;
+        bool loading = false;
+        long lastUsed = 0;
+    };
+
+    struct ChunkLoad {
+        ChunkSamples samples;
+        ChunkGeometry geometry;
+    };
+
+    std::vector<Chunk> chunks;  // one per quadtree node
+    std::vector<int> selected;
+    long frame = 0;
+    int generation = 0;
+    int loads = 0;
+    Vector3 placedOrigin = { 0, 0, 0 };
+    Vector3 placedSize = { 0, 0, 0 };
+
+    void ReleaseMeshes() {
+        for (Chunk& chunk : chunks) {
+            if (chunk.ready) UnloadMesh(chunk.mesh);
+            chunk = Chunk{};
+        }
+        generation++; // builds still in flight are dropped when they arrive
+        loads = 0;
+    }
+
+    // Vertices are in world space, so after the ground moved every mesh is
+    // made again. Only the root is built here; the tree's heights still hold.
+    void Remesh() {
+        ReleaseMeshes();
+        placedOrigin = quadtree.GetTerrain()->origin;
+        placedSize = quadtree.GetTerrain()->size;
+        if (!chunks.empty()) Upload(0, BuildChunkGeometry(quadtree.GetSamples(0)));
+    }
+
+    void Request(int index, AssetStreamer& streamer) {
+        Chunk& chunk = chunks[index];
+        if (chunk.ready || chunk.loading || loads >= maxLoads) return;
+        chunk.loading = true;
+        loads++;
+        std::shared_ptr<ChunkLoad> load = std::make_shared<ChunkLoad>();
+        load->samples = quadtree.GetSamples(index);
+        streamer.Load([load] { load->geometry = BuildChunkGeometry(load->samples); },
+            [this, load, index, built = generation] {
+                if (built != generation) return;
+                loads--;
+                chunks[index].loading = false;
+                Upload(index, load->geometry);
+                chunks[index].lastUsed = frame;
+            });
+    }
+
+    void Upload(int index, const ChunkGeometry& geometry) {
+        Mesh mesh = { 0 };
+        mesh.vertexCount = geometry.GetVertexCount();
+        mesh.triangleCount = geometry.GetTriangleCount();
+        mesh.vertices = (float*)MemAlloc((unsigned int)(geometry.vertices.size() * sizeof(float)));
+        mesh.normals = (float*)MemAlloc((unsigned int)(geometry.normals.size() * sizeof(float)));
+        mesh.texcoords = (float*)MemAlloc((unsigned int)(geometry.texcoords.size() * sizeof(float)));
+        mesh.indices = (unsigned short*)MemAlloc((unsigned int)(geometry.indices.size() * sizeof(unsigned short)));
+        memcpy(mesh.vertices, geometry.vertices.data(), geometry.vertices.size() * sizeof(float));
+        memcpy(mesh.normals, geometry.normals.data(), geometry.normals.size() * sizeof(float));
+        memcpy(mesh.texcoords, geometry.texcoords.data(), geometry.texcoords.size() * sizeof(float));
+        memcpy(mesh.indices, geometry.indices.data(), geometry.indices.size() * sizeof(unsigned short));
+        UploadMesh(&mesh, false);
+        chunks[index].mesh = mesh;
+        chunks[index].ready = true;
+    }
+};
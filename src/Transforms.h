@@ -0,0 +1,82 @@
+#pragma once
+#include "raylib.h"
+#include <cmath>
+#include <vector>
+
+// Builds translate * rotateX * rotateY * rotateZ * scale in one pass. Same
+// result as chaining MatrixRotateX/Y/Z and MatrixMultiply, but with one
+// sin/cos per axis and no matrix multiplies. Rotation is in degrees.
+Matrix ComposeTransform(Vector3 position, Vector3 rotation, Vector3 scale) {
+    float sa = sinf(DEG2RAD * rotation.x), ca = cosf(DEG2RAD * rotation.x);
+    float sb = sinf(DEG2RAD * rotation.y), cb = cosf(DEG2RAD * rotation.y);
+    float sc = sinf(DEG2RAD * rotation.z), cc = cosf(DEG2RAD * rotation.z);
+
+    Matrix m;
+    m.m0 = cb * cc * scale.x;
+    m.m4 = -cb * sc * scale.y;
+    m.m8 = sb * scale.z;
+    m.m12 = position.x;
+
+    m.m1 = (ca * sc + sa * sb * cc) * scale.x;
+    m.m5 = (ca * cc - sa * sb * sc) * scale.y;
+    m.m9 = -sa * cb * scale.z;
+    m.m13 = position.y;
+
+    m.m2 = (sa * sc - ca * sb * cc) * scale.x;
+    m.m6 = (sa * cc + ca * sb * sc) * scale.y;
+    m.m10 = ca * cb * scale.z;
+    m.m14 = position.z;
+
+    m.m3 = 0.0f; m.m7 = 0.0f; m.m11 = 0.0f; m.m15 = 1.0f;
+    return m;
+}
+
+// Structure-of-arrays transform inputs for batch composition
+struct TransformArrays {
+    std::vector<float> px, py, pz; // position
+    std::vector<float> rx, ry, rz; // rotation, degrees
+    std::vector<float> sx, sy, sz; // scale
+    int count = 0;
+
+    void Resize(int n) {
+        count = n;
+        px.assign(n, 0.0f); py.assign(n, 0.0f); pz.assign(n, 0.0f);
+        rx.assign(n, 0.0f); ry.assign(n, 0.0f); rz.assign(n, 0.0f);
+        sx.assign(n, 1.0f); sy.assign(n, 1.0f); sz.assign(n, 1.0f);
+    }
+
+    void Set(int i, Vector3 position, Vector3 rotation, Vector3 scale) {
+        px[i] = position.x; py[i] = position.y; pz[i] = position.z;
+        rx[i] = rotation.x; ry[i] = rotation.y; rz[i] = rotation.z;
+        sx[i] = scale.x; sy[i] = scale.y; sz[i] = scale.z;
+    }
+};
+
+// Same math as ComposeTransform over whole arrays. Every loop is branch free
+// over contiguous floats so the compiler can vectorize it, including the
+// sin/cos pass on compilers with a vector math library.
+void ComposeTransforms(const TransformArrays& in, Matrix* out) {
+    int n = in.count;
+    std::vector<float> sa(n), ca(n), sb(n), cb(n), sc(n), cc(n);
+    for (int i = 0; i < n; i++) {
+        sa[i] = sinf(DEG2RAD * in.rx[i]); ca[i] = cosf(DEG2RAD * in.rx[i]);
+        sb[i] = sinf(DEG2RAD * in.ry[i]); cb[i] = cosf(DEG2RAD * in.ry[i]);
+        sc[i] = sinf(DEG2RAD * in.rz[i]); cc[i] = cosf(DEG2RAD * in.rz[i]);
+    }
+    for (int i = 0; i < n; i++) {
+        Matrix& m = out[i];
+        m.m0 = cb[i] * cc[i] * in.sx[i];
+        m.m4 = -cb[i] * sc[i] * in.sy[i];
+        m.m8 = sb[i] * in.sz[i];
+        m.m12 = in.px[i];
+        m.m1 = (ca[i] * sc[i] + sa[i] * sb[i] * cc[i]) * in.sx[i];
+        m.m5 = (ca[i] * cc[i] - sa[i] * sb[i] * sc[i]) * in.sy[i];
+        m.m9 = -sa[i] * cb[i] * in.sz[i];
+        m.m13 = in.py[i];
+        m.m2 = (sa[i] * sc[i] - ca[i] * sb[i] * cc[i]) * in.sx[i];
+        m.m6 = (sa[i] * cc[i] + ca[i] * sb[i] * sc[i]) * in.sy[i];
+        m.m10 = ca[i] * cb[i] * in.sz[i];
+        m.m14 = in.pz[i];
+        m.m3 = 0.0f; m.m7 = 0.0f; m.m11 = 0.0f; m.m15 = 1.0f;
+    }
+}
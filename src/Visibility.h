@@ -0,0 +1,83 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "Frustum.h"
+#include <cmath>
+
+// How much of a character to update this frame
+struct CharacterLod {
+    bool visible = true;
+    int animationInterval = 1;  // frames between pose updates
+};
+
+// What the camera sees this frame, worked out once in Begin and asked by
+// everything that draws. Besides the frustum, things too small on screen to
+// matter are dropped: that is the distance cull, scaled by size, so a big
+// block is kept further out than a small one. Plain CPU work.
+class Visibility {
+public:
+    float minScreenSize = 0.002f;   // share of the view height below which nothing is drawn
+    float fullRateSize = 0.15f;     // characters at least this big animate every frame,
+    float halfRateSize = 0.05f;     // this big every second frame, smaller every fourth
+
+    Frustum frustum;
+
+    // aspect of the render target being culled for (TargetDesc::GetAspect),
+    // not the window's: the frustum's side planes come from it
+    void Begin(const Camera3D& camera, float aspect) {
+        frustum = ExtractFrustum(camera, aspect);
+        eye = camera.position;
+        heightAtOne = 2.0f * tanf(camera.fovy * 0.5f * DEG2RAD);
+    }
+
+    // Roughly the share of the view height the box covers, from its bounding
+    // sphere; 1 when the camera is inside the sphere
+    float GetScreenSize(const BoundingBox& box) const {
+        Vector3 center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+        float radius = 0.5f * Vector3Distance(box.min, box.max);
+        float distance = Vector3Distance(center, eye);
+        if (distance <= radius) return 1.0f;
+        return 2.0f * radius / (distance * heightAtOne);
+    }
+
+    // GetScreenSize(box) < minScreenSize, without the square roots
+    bool IsTooSmall(const BoundingBox& box) const {
+        Vector3 center = Vector3Scale(Vector3Add(box.min, box.max), 0.5f);
+        return IsTooSmall(Vector3DistanceSqr(box.min, box.max), Vector3DistanceSqr(center, eye));
+    }
+
+    // For walking a tree of boxes (AABBTree::QueryVolume): -1 when nothing in
+    // box can be visible, otherwise the frustum's answer. Anything inside box
+    // is no bigger and no nearer than box's nearest point, so judging box by
+    // that point never drops something visible.
+    int ClassifyBox(const BoundingBox& box, bool insideFrustum) const {
+        Vector3 nearest = Vector3Clamp(eye, box.min, box.max);
+        if (IsTooSmall(Vector3DistanceSqr(box.min, box.max), Vector3DistanceSqr(nearest, eye))) return -1;
+        return insideFrustum ? 1 : frustum.ClassifyBox(box);
+    }
+
+    Vector3 GetEye() const { return eye; }
+
+    bool IsVisible(const BoundingBox& box) const {
+        return frustum.IntersectsBox(box) && GetScreenSize(box) >= minScreenSize;
+    }
+
+    CharacterLod TestCharacter(const BoundingBox& box) const {
+        CharacterLod lod;
+        float size = GetScreenSize(box);
+        lod.visible = frustum.IntersectsBox(box) && size >= minScreenSize;
+        lod.animationInterval = size >= fullRateSize ? 1 : (size >= halfRateSize ? 2 : 4);
+        return lod;
+    }
+
+private:
+    Vector3 eye = { 0, 0, 0 };
+    float heightAtOne = 2.0f;       // view height one unit in front of the camera
+
+    // Screen size 2r / (d * heightAtOne) against the minimum, from the box's
+    // squared diagonal (2r squared) and squared distance
+    bool IsTooSmall(float diagonalSq, float distanceSq) const {
+        float limit = minScreenSize * heightAtOne;
+        return distanceSq > diagonalSq * 0.25f && diagonalSq < limit * limit * distanceSq;
+    }
+};
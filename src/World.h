@@ -0,0 +1,139 @@
+#pragma once
+#include "raylib.h"
+#include "raymath.h"
+#include "Classes.h"
+#include "RopeWorld.h"
+#include "Profiler.h"
+#include "Input.h"
+#include <vector>
+
+// Fixed-rate simulation clock. Frame time is accumulated and drained in whole
+// steps; whatever is left over becomes alpha for interpolating render state.
+class FixedTimestep {
+public:
+    float stepRate = 120.0f;    // simulation Hz (120 or 240)
+    int maxSubSteps = 8;        // cap per frame so one hitch can't snowball
+    float maxFrameTime = 0.25f; // frame times above this are clamped
+    float accumulator = 0.0f;
+    float alpha = 0.0f;
+
+    float StepDt() const { return 1.0f / stepRate; }
+
+    // Returns how many fixed steps to run for this frame
+    int Accumulate(float frameTime) {
+        float dt = StepDt();
+        accumulator += fminf(frameTime, maxFrameTime);
+
+        int steps = (int)(accumulator / dt);
+        if (steps > maxSubSteps) {
+            // Drop the time we can't catch up on instead of carrying it forward
+            steps = maxSubSteps;
+            accumulator = dt * steps;
+        }
+        accumulator -= dt * steps;
+        alpha = accumulator / dt;
+        return steps;
+    }
+};
+
+// Everything the simulation touches. Nothing in Step() needs a window or GPU,
+// so a World can be stepped headlessly for benchmarks and regression runs.
+class World {
+public:
+    std::vector<Block> blocks;
+    AABBTree broadphase;
+    Player* player = nullptr;
+    RopeWorld ropes;
+    int playerRope = -1;        // the player's grapple in ropes, -1 when not attached
+    PlayerInput input;
+    FixedTimestep clock;
+    long long stepCount = 0;
+
+    Block& AddBlock(const Block& block) {
+        blocks.push_back(block);
+        Block& added = blocks.back();
+        added.PlaceTerrain();
+        added.UpdateOrientedBox();
+        added.proxyId = broadphase.CreateProxy(added.GetBounds(), (int)blocks.size() - 1);
+        return added;
+    }
+
+    // Call after a block is moved or resized outside the simulation (e.g. the Block Editor)
+    void RefreshBlock(Block& block) {
+        block.transformDirty = true;
+        block.PlaceTerrain();
+        block.UpdateOrientedBox();
+        broadphase.MoveProxy(block.proxyId, block.GetBounds());
+    }
+
+    void RebuildBroadphase() {
+        broadphase.Clear();
+        for (int i = 0; i < blocks.size(); i++) {
+            blocks[i].proxyId = broadphase.CreateProxy(blocks[i].GetBounds(), i);
+        }
+    }
+
+    // Grapples the player to target, replacing any previous grapple
+    void AttachRope(Block* target, int pointCount = 50) {
+        if (player == nullptr || target == nullptr) return;
+        ropes.Detach(playerRope);
+        int index = (int)(target - blocks.data());
+        playerRope = ropes.Attach(RopeAnchor::OnPlayer(), RopeAnchor::OnBlock(index), blocks, player->position, pointCount);
+        Rope* rope = ropes.Get(playerRope);
+        rope->startInvMass = rope->GetPointMass() / player->mass;
+    }
+
+    Rope* GetPlayerRope() { return ropes.Get(playerRope); }
+
+    // Latches edge-triggered input so a frame that runs zero steps doesn't drop it
+    void SetInput(const PlayerInput& next) {
+        bool jump = input.jump || next.jump;
+        input = next;
+        input.jump = jump;
+    }
+
+    void Step(float dt) {
+        PROFILE_ZONE("Step");
+        Rope* grapple = GetPlayerRope();
+        if (player != nullptr) {
+            PROFILE_ZONE("Player update");
+            // The grapple holds the player to its length; the rope's own
+            // solve below then pulls the player end by the mass ratio
+            if (grapple != nullptr) {
+                grapple->Reel(input.reel * player->reelSpeed * dt);
+                player->SetTether(grapple->GetPoint(grapple->numPoints - 1), grapple->restLength);
+            }
+            else {
+                player->ClearTether();
+            }
+            player->PlayerController(input, dt);
+            player->Update(blocks, broadphase, dt);
+        }
+        {
+            PROFILE_ZONE("Rope update");
+            ropes.Step(blocks, broadphase, player != nullptr ? player->position : Vector3{ 0, 0, 0 }, dt);
+        }
+        if (player != nullptr && grapple != nullptr) player->FollowRope(grapple->GetPoint(0), dt);
+        stepCount++;
+    }
+
+    // Runs however many fixed steps this frame owes and updates interpolated state
+    int Advance(float frameTime) {
+        int steps = clock.Accumulate(frameTime);
+        for (int i = 0; i < steps; i++) {
+            Step(clock.StepDt());
+            input.jump = false; // edge-triggered, only the first sub-step sees it
+        }
+        if (player != nullptr) player->Interpolate(clock.alpha);
+        return steps;
+    }
+
+    // One rendered frame's worth of simulation, in the order the game loop
+    // does it. Live play and replays both go through here, so a recorded
+    // session steps the world exactly as it was played.
+    int RunFrame(const InputFrame& frame) {
+        if (frame.attachBlock >= 0 && frame.attachBlock < (int)blocks.size()) AttachRope(&blocks[frame.attachBlock], 50);
+        SetInput(ReadPlayerInput(frame));
+        return Advance(frame.frameTime);
+    }
+};
@@ -0,0 +1,21 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in mat4 instanceTransform;
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main()
+{
+    // Per-batch color comes from colDiffuse in the default fragment shader
+    fragTexCoord = vertexTexCoord;
+    fragColor = vec4(1.0);
+    gl_Position = mvp*instanceTransform*vec4(vertexPosition, 1.0);
+}